@@ -0,0 +1,276 @@
+/**
+* @file batch_generator.h
+* @brief Parallel, reproducible generation of circuit board instance sets
+*
+* Batch stage that turns a list of board configurations and a seed range
+* into instance files plus a manifest for the downstream solvers:
+* - Boards are generated (layout + distance matrix) on a ThreadPool
+* - Files are written by a single AsyncInstanceWriter thread, so disk I/O
+*   overlaps with generation of the next boards
+* - File names are derived from configuration and seed only
+*   (data/<category>/board_<W>x<H>_c<components>_s<seed>.dat), so rerunning
+*   the same batch reproduces the same files
+* - The manifest (CSV) lists every instance in configuration/seed order
+* - Costs come from the configured CostModel (Euclidean mm by default)
+*/
+
+#ifndef BATCH_GENERATOR_H
+#define BATCH_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include <tuple>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <exception>
+#include <filesystem>
+#include "data_generator.h"
+#include "thread_pool.h"
+#include "cost_model.h"
+
+/**
+* Serializes instance files on a background thread through a bounded queue.
+* Producers block in enqueue() when the queue is full, which caps the number
+* of finished cost matrices held in memory.
+*/
+class AsyncInstanceWriter {
+public:
+    explicit AsyncInstanceWriter(std::size_t capacity = 8)
+        : capacity(capacity ? capacity : 1), closed(false),
+          worker([this] { writerLoop(); }) {}
+
+    ~AsyncInstanceWriter() {
+        close();
+    }
+
+    AsyncInstanceWriter(const AsyncInstanceWriter&) = delete;
+    AsyncInstanceWriter& operator=(const AsyncInstanceWriter&) = delete;
+
+    void enqueue(std::string filename, std::vector<std::vector<double>> costs,
+        std::string metadata) {
+        std::unique_lock<std::mutex> lock(mutex);
+        space_available.wait(lock, [this] { return closed || jobs.size() < capacity; });
+        if (closed) throw std::runtime_error("enqueue on closed AsyncInstanceWriter");
+        jobs.push_back({ std::move(filename), std::move(costs), std::move(metadata) });
+        work_available.notify_one();
+    }
+
+    // Drains the queue and joins the writer; returns the write errors, if any
+    std::vector<std::string> close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        work_available.notify_all();
+        space_available.notify_all();
+        if (worker.joinable()) worker.join();
+        return errors;
+    }
+
+private:
+    struct Job {
+        std::string filename;
+        std::vector<std::vector<double>> costs;
+        std::string metadata;
+    };
+
+    std::size_t capacity;
+    bool closed;
+    std::deque<Job> jobs;
+    std::vector<std::string> errors;
+    std::mutex mutex;
+    std::condition_variable work_available;
+    std::condition_variable space_available;
+    std::thread worker;
+
+    void writerLoop() {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_available.wait(lock, [this] { return closed || !jobs.empty(); });
+                if (jobs.empty()) return;
+                job = std::move(jobs.front());
+                jobs.pop_front();
+            }
+            space_available.notify_one();
+
+            try {
+                TSPGenerator::saveToFile(job.filename, job.costs, job.metadata);
+            }
+            catch (const std::exception& e) {
+                std::lock_guard<std::mutex> lock(mutex);
+                errors.push_back(e.what());
+            }
+        }
+    }
+};
+
+class BatchGenerator {
+public:
+    struct ManifestEntry {
+        std::string filename;
+        std::string category;
+        int width;
+        int height;
+        int components;
+        unsigned seed;
+        int nodes;
+        std::string cost_model;
+    };
+
+    explicit BatchGenerator(const std::string& data_dir = "data", unsigned workers = 0,
+        const CostModel& cost_model = CostModel())
+        : data_dir(data_dir), workers(workers), cost_model(cost_model) {}
+
+    static std::string sizeCategory(int N) {
+        if (N <= 20) return "small";
+        if (N <= 35) return "medium";
+        return "large";
+    }
+
+    /**
+    * Generates one board per (configuration, seed) pair for seeds in
+    * [first_seed, last_seed]. Seed 0 is rejected because the generator maps
+    * it to a nondeterministic random_device seed.
+    */
+    std::vector<ManifestEntry> run(const std::vector<std::tuple<int, int, int>>& board_configs,
+        unsigned first_seed, unsigned last_seed) {
+
+        if (first_seed == 0 || last_seed < first_seed) {
+            throw std::invalid_argument("BatchGenerator: seed range must be 1 <= first <= last");
+        }
+
+        for (const auto& folder : { "small", "medium", "large" }) {
+            std::filesystem::create_directories(std::filesystem::path(data_dir) / folder);
+        }
+
+        // The writer is declared first so it outlives the pool, whose
+        // destructor still runs queued tasks that enqueue through it
+        const unsigned pool_size = workers ? workers : ThreadPool::defaultWorkers();
+        AsyncInstanceWriter writer(2 * static_cast<std::size_t>(pool_size));
+        ThreadPool pool(pool_size);
+        std::vector<std::future<ManifestEntry>> pending;
+
+        for (const auto& config : board_configs) {
+            int width = std::get<0>(config);
+            int height = std::get<1>(config);
+            int components = std::get<2>(config);
+
+            for (unsigned seed = first_seed; seed <= last_seed; seed++) {
+                pending.push_back(pool.submit([this, &writer, width, height, components, seed] {
+                    auto holes = TSPGenerator::generateHoles(width, height, components, seed);
+                    auto costs = cost_model.buildMatrix(holes, 1);  // parallel across boards instead
+
+                    ManifestEntry entry;
+                    entry.width = width;
+                    entry.height = height;
+                    entry.components = components;
+                    entry.seed = seed;
+                    entry.nodes = static_cast<int>(costs.size());
+                    entry.category = sizeCategory(entry.nodes);
+                    entry.cost_model = cost_model.name();
+                    entry.filename = instanceFilename(entry);
+
+                    writer.enqueue(entry.filename, std::move(costs),
+                        "Circuit board instance\nSize: " + entry.category +
+                        "\nNodes: " + std::to_string(entry.nodes) +
+                        "\nSeed: " + std::to_string(seed) +
+                        "\nCost model: " + entry.cost_model + " (" + cost_model.units() + ")");
+                    return entry;
+                }));
+                if (seed == last_seed) break;  // guard against wrap at UINT_MAX
+            }
+        }
+
+        // Collect in submission order so the manifest does not depend on
+        // scheduling. Queued tasks still write through `writer`, so every one
+        // is waited for before the first error is rethrown
+        std::vector<ManifestEntry> manifest;
+        manifest.reserve(pending.size());
+        std::exception_ptr failure;
+        for (auto& result : pending) {
+            try {
+                manifest.push_back(result.get());
+            }
+            catch (...) {
+                if (!failure) failure = std::current_exception();
+            }
+        }
+        if (failure) {
+            writer.close();
+            std::rethrow_exception(failure);
+        }
+
+        auto errors = writer.close();
+        if (!errors.empty()) {
+            throw std::runtime_error("BatchGenerator: " + errors.front());
+        }
+
+        writeManifest(manifestPath(), manifest);
+        return manifest;
+    }
+
+    std::string manifestPath() const {
+        return (std::filesystem::path(data_dir) / "manifest.csv").string();
+    }
+
+    static void writeManifest(const std::string& filename,
+        const std::vector<ManifestEntry>& manifest) {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file: " + filename);
+
+        out << "file,category,width,height,components,seed,nodes,cost_model\n";
+        for (const auto& e : manifest) {
+            out << e.filename << "," << e.category << "," << e.width << ","
+                << e.height << "," << e.components << "," << e.seed << ","
+                << e.nodes << "," << e.cost_model << "\n";
+        }
+    }
+
+    static std::vector<ManifestEntry> loadManifest(const std::string& filename) {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file: " + filename);
+
+        std::vector<ManifestEntry> manifest;
+        std::string line;
+        std::getline(in, line);  // header
+        while (std::getline(in, line)) {
+            if (line.empty()) continue;
+            std::istringstream fields(line);
+            ManifestEntry e;
+            std::string value;
+            std::getline(fields, e.filename, ',');
+            std::getline(fields, e.category, ',');
+            std::getline(fields, value, ','); e.width = std::stoi(value);
+            std::getline(fields, value, ','); e.height = std::stoi(value);
+            std::getline(fields, value, ','); e.components = std::stoi(value);
+            std::getline(fields, value, ','); e.seed = static_cast<unsigned>(std::stoul(value));
+            std::getline(fields, value, ','); e.nodes = std::stoi(value);
+            if (!std::getline(fields, e.cost_model, ',')) e.cost_model = "euclidean";
+            manifest.push_back(e);
+        }
+        return manifest;
+    }
+
+private:
+    std::string data_dir;
+    unsigned workers;
+    CostModel cost_model;
+
+    std::string instanceFilename(const ManifestEntry& e) const {
+        std::ostringstream name;
+        name << "board_" << e.width << "x" << e.height << "_c" << e.components
+            << "_s" << std::setw(4) << std::setfill('0') << e.seed << ".dat";
+        return (std::filesystem::path(data_dir) / e.category / name.str()).string();
+    }
+};
+
+#endif /* BATCH_GENERATOR_H */
@@ -0,0 +1,81 @@
+/**
+* @file batch_solver.h
+* @brief Concurrent exact solves of a batch of TSP instances
+*
+* Runs several TSPModel solves at the same time under a fixed core budget:
+* - Each solve gets a thread budget by size (CPX_PARAM_THREADS): 1 thread
+*   for small boards, 2 for medium, and for large ones the whole budget
+*   minus SMALL_JOB_SHARE of it (at least one core when there are two or
+*   more), so small boards keep running next to a large solve; a nonzero
+*   max_threads_per_solve caps all three
+* - Jobs are dispatched largest first (LPT); when the next large job does
+*   not fit the idle cores, smaller ones are backfilled alongside the
+*   running solves, so cores do not sit idle waiting for a big slot
+* - CPLEX environments come from an EnvPool and are reused across jobs and
+*   across run() calls instead of being opened per instance
+*
+* Results are returned in job order whatever the completion order. A job
+* that throws is reported through BatchResult::error and does not stop the
+* batch. Requires the thread_local status/errmsg from cpxmacro.h.
+*/
+
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <cpxmacro.h>
+#include <model.h>
+#include <vector>
+#include <string>
+#include <functional>
+#include <mutex>
+
+// Idle CPLEX environments, reset to default parameters before reuse
+class EnvPool {
+public:
+    EnvPool() = default;
+    EnvPool(const EnvPool&) = delete;
+    EnvPool& operator=(const EnvPool&) = delete;
+    ~EnvPool();
+
+    Env acquire();
+    void release(Env env);
+    std::size_t opened() const;
+
+private:
+    mutable std::mutex mutex;
+    std::vector<Env> idle;
+    std::vector<Env> all;
+};
+
+struct BatchJob {
+    std::string name;
+    std::vector<std::vector<double>> costs;
+    Formulation formulation = Formulation::GAVISH_GRAVES;
+    double time_limit = 300.0;
+    // Optional, runs on the worker before createModel (warm start, candidates, ...)
+    std::function<void(TSPModel&, const BatchJob&)> prepare;
+};
+
+class BatchSolver {
+public:
+    // 0 = all hardware threads / no per-solve cap beyond the budget
+    explicit BatchSolver(unsigned total_threads = 0, unsigned max_threads_per_solve = 0);
+
+    std::vector<BatchResult> run(const std::vector<BatchJob>& jobs);
+
+    // Fraction of the budget a large solve leaves to smaller jobs
+    static constexpr double SMALL_JOB_SHARE = 0.25;
+
+    int threadsFor(int nodes) const;
+    unsigned getTotalThreads() const { return total_threads; }
+    std::size_t environments() const { return pool.opened(); }
+
+private:
+    unsigned total_threads;
+    unsigned max_threads_per_solve;
+    EnvPool pool;
+
+    BatchResult solveOne(const BatchJob& job, int threads);
+};
+
+#endif /* BATCH_SOLVER_H */
@@ -0,0 +1,54 @@
+/**
+* @file candidate_graph.h
+* @brief Candidate arc sets for the sparse TSP model
+*
+* Optimal drilling tours use short edges almost exclusively, so the MIP only
+* needs variables for a small neighbourhood of each hole. The candidate set
+* is the union of:
+* - addNearest(): the k cheapest arcs out of every node
+* - addDelaunay(): edges of the Delaunay triangulation (Bowyer-Watson),
+*   which contains the Euclidean minimum spanning tree and, empirically,
+*   nearly all edges of optimal tours
+* - addTour(): the edges of a heuristic tour, which guarantees the sparse
+*   model is feasible
+*
+* All edges are added in both directions. Missing arcs are recovered by
+* TSPModel's pricing loop, so the set only affects speed, never optimality.
+*/
+
+#ifndef CANDIDATE_GRAPH_H
+#define CANDIDATE_GRAPH_H
+
+#include <vector>
+
+namespace CandidateGraph {
+
+    // arcs[i][j] != 0 when arc (i,j) is a candidate
+    typedef std::vector<std::vector<char>> Arcs;
+
+    Arcs empty(int N);
+
+    void addNearest(Arcs& arcs, const std::vector<std::vector<double>>& costs, int k);
+
+    void addDelaunay(Arcs& arcs, const std::vector<double>& xs, const std::vector<double>& ys);
+
+    template <typename PointT>
+    void addDelaunay(Arcs& arcs, const std::vector<PointT>& points) {
+        std::vector<double> xs, ys;
+        xs.reserve(points.size());
+        ys.reserve(points.size());
+        for (const auto& p : points) {
+            xs.push_back(p.x);
+            ys.push_back(p.y);
+        }
+        addDelaunay(arcs, xs, ys);
+    }
+
+    void addTour(Arcs& arcs, const std::vector<int>& tour);
+
+    // Number of directed candidate arcs
+    long count(const Arcs& arcs);
+
+}
+
+#endif /* CANDIDATE_GRAPH_H */
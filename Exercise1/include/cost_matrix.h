@@ -0,0 +1,35 @@
+/**
+* @file cost_matrix.h
+* @brief Checks on dense cost matrices shared by every backend
+*
+* CPLEX-free, like solve_result.h, so the CPLEX model, the in-tree
+* ExactSolver and the tour heuristics agree on when a matrix counts as
+* symmetric.
+*/
+
+#ifndef COST_MATRIX_H
+#define COST_MATRIX_H
+
+#include <vector>
+#include <cmath>
+
+namespace CostMatrix {
+
+    // Default tolerance: generated matrices are exactly symmetric, files
+    // written with 6 decimals round both halves the same way
+    constexpr double SYMMETRY_TOLERANCE = 1e-9;
+
+    // True if |c_ij - c_ji| <= tolerance for every pair
+    inline bool isSymmetric(const std::vector<std::vector<double>>& costs,
+        double tolerance = SYMMETRY_TOLERANCE) {
+        for (std::size_t i = 0; i < costs.size(); i++) {
+            for (std::size_t j = i + 1; j < costs.size(); j++) {
+                if (std::abs(costs[i][j] - costs[j][i]) > tolerance) return false;
+            }
+        }
+        return true;
+    }
+
+}
+
+#endif /* COST_MATRIX_H */
@@ -25,13 +25,14 @@ typedef CPXCENVptr CEnv;
 typedef CPXLPptr Prob;
 typedef CPXCLPptr CProb;
 
-/* Cplex Error Status and Message Buffer */
+/* Cplex Error Status and Message Buffer, one per thread so that
+ * concurrent solves can use the macros below */
 
-extern int status;
+extern thread_local int status;
 
 const unsigned int BUF_SIZE = 4096;
 
-extern char errmsg[BUF_SIZE];
+extern thread_local char errmsg[BUF_SIZE];
 
 /* Shortcut for declaring a Cplex Env */
 #define DECL_ENV(name) \
@@ -0,0 +1,50 @@
+/**
+* @file exact_solver.h
+* @brief CPLEX-free exact TSP solver for small boards
+*
+* Proves optimality on machines without a CPLEX license (CI, line PCs):
+* - N <= DP_MAX_NODES: Held-Karp bitmask dynamic programming, O(2^N N^2)
+*   time and O(2^N N) memory; subsets of equal size are processed in
+*   parallel. Any cost matrix
+* - N <= BRANCH_MAX_NODES: depth-first branch-and-bound on edges with
+*   Held-Karp 1-tree bounds (subgradient penalties inherited from the
+*   parent). The root is expanded breadth-first into a frontier whose
+*   subtrees are searched in parallel, sharing the incumbent. Symmetric
+*   costs only
+*
+* solve() returns the same SolveResult as TSPModel::solve. On the time
+* limit the branch-and-bound returns its incumbent with the root bound.
+*/
+
+#ifndef EXACT_SOLVER_H
+#define EXACT_SOLVER_H
+
+#include <solve_result.h>
+#include <vector>
+#include <string>
+
+class ExactSolver {
+public:
+    static constexpr int DP_MAX_NODES = 20;        // 2^19 x 19 states, 80 MB
+    static constexpr int BRANCH_MAX_NODES = 100;
+
+    explicit ExactSolver(unsigned threads = 0, double time_limit = 300.0);
+
+    void setThreads(unsigned count);
+    void setTimeLimit(double seconds) { time_limit = seconds; }
+    unsigned getThreads() const { return threads; }
+
+    static bool supports(int N) { return N <= BRANCH_MAX_NODES; }
+    static std::string method(int N);
+
+    SolveResult solve(const std::vector<std::vector<double>>& costs) const;
+
+private:
+    unsigned threads;
+    double time_limit;
+
+    SolveResult solveDynamicProgramming(const std::vector<std::vector<double>>& costs) const;
+    SolveResult solveBranchAndBound(const std::vector<std::vector<double>>& costs) const;
+};
+
+#endif /* EXACT_SOLVER_H */
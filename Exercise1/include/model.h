@@ -17,6 +17,48 @@
 * - Flow conservation constraints
 * - Assignment constraints ensuring each node is visited exactly once
 * - Linking constraints between flow and path variables
+*
+* Formulation::LAZY_SUBTOUR drops the flow variables and linking rows and
+* keeps only y with the degree constraints. Subtours are cut off lazily by a
+* CPLEX generic callback (Dantzig-Fulkerson-Johnson SECs):
+* - Integer candidates: connected components of the selected arcs; each
+*   subtour S is rejected with an SEC
+* - Fractional LP points: Stoer-Wagner minimum cut on y_ij + y_ji; cuts of
+*   weight < 2 are added as user cuts, strengthening the relaxation
+*
+* Formulation::SYMMETRIC needs a symmetric cost matrix
+* (CostMatrix::isSymmetric()) and uses one binary z_ij per undirected edge
+* {i,j} with degree rows sum_j z_ij = 2, halving the binaries. It shares
+* the lazy SEC callback; the undirected cuts read
+* sum_{i<j in S} z_ij <= |S|-1 or z(delta(S)) >= 2. map_y[i][j] and
+* map_y[j][i] both refer to z_ij.
+*
+* Warm start: setInitialTour() injects a heuristic tour as a MIP start
+* (CPXaddmipstarts). For the flow model the start is completed with the
+* flow it implies, x(t_p, t_p+1) = N-1-p along the tour from node 0, so
+* CPLEX accepts it without a repair step. setCutoff() passes an upper bound
+* (CPX_PARAM_CUTUP) so nodes that cannot beat it are pruned immediately.
+*
+* Sparse mode: setCandidateArcs() restricts the variables to a candidate
+* graph (see candidate_graph.h). Missing arcs are priced on the LP
+* relaxation, with duals alpha (out-degree), beta (in-degree) and mu (flow,
+* mu_0 = 0); choosing the best dual for the absent linking row gives
+*     rc_ij = c_ij - alpha_i - beta_j + (N-1) * min(0, mu_i - mu_j)
+* Arcs with rc < 0 are added until the sparse LP equals the full one. After
+* the MIP, every arc of a tour cheaper than the incumbent z has
+* rc < z - z_LP, so adding those arcs and solving once more proves
+* optimality over the complete graph.
+*
+* solve() checks CPXsolninfo before reading the incumbent, rebuilds the
+* tour from a successor array in one pass over the arc values, and
+* validates it (permutation, single closed cycle, cost equal to the
+* objective). Status, bound, gap, node count and timing are returned in a
+* SolveResult.
+*
+* The model is assembled into preallocated column arrays and a CSR row
+* buffer, then handed to CPLEX with a single CPXnewcols and a single
+* CPXaddrows call. Variable names are optional (off by default) since they
+* only matter when exporting or debugging the LP.
 */
 
 #ifndef MODEL_H
@@ -24,28 +66,135 @@
 
 #include <ilcplex/cplex.h>  
 #include <cpxmacro.h>       
+#include <solve_result.h>
 #include <vector>
 #include <string>
 #include <iomanip>
 #include <fstream>
 #include <sstream>
 
+enum class Formulation {
+    GAVISH_GRAVES,   // compact single-commodity flow model
+    LAZY_SUBTOUR,    // y only, SECs separated in a callback
+    SYMMETRIC        // one z_ij per edge, degree 2, SECs in a callback
+};
+
+inline const char* formulationName(Formulation formulation) {
+    switch (formulation) {
+    case Formulation::LAZY_SUBTOUR: return "CPLEX, lazy subtour elimination";
+    case Formulation::SYMMETRIC: return "CPLEX, symmetric edge formulation";
+    default: return "CPLEX, Gavish-Graves flow formulation";
+    }
+}
+
 class TSPModel {
 private:
+    // Rows in CPXaddrows (CSR) layout, filled before a single API call
+    struct RowBuffer {
+        std::vector<double> rhs;
+        std::vector<char> sense;
+        std::vector<int> rmatbeg;
+        std::vector<int> rmatind;
+        std::vector<double> rmatval;
+
+        void reserve(std::size_t rows, std::size_t nonzeros) {
+            rhs.reserve(rows);
+            sense.reserve(rows);
+            rmatbeg.reserve(rows);
+            rmatind.reserve(nonzeros);
+            rmatval.reserve(nonzeros);
+        }
+        void beginRow(char row_sense, double row_rhs) {
+            rmatbeg.push_back(static_cast<int>(rmatind.size()));
+            sense.push_back(row_sense);
+            rhs.push_back(row_rhs);
+        }
+        void add(int column, double value) {
+            rmatind.push_back(column);
+            rmatval.push_back(value);
+        }
+    };
+
     // Variable mappings
     std::vector<std::vector<int>> map_x;  // Flow variables x[i][j], j≠0 
     std::vector<std::vector<int>> map_y;  // Path variables y[i][j]
+    bool use_names;
+    Formulation formulation;
+    int num_cols;
+    int num_arcs;
+    int first_arc;                 // y columns are first_arc .. first_arc + num_arcs - 1
+    std::vector<int> arc_tail;     // endpoints of each y column
+    std::vector<int> arc_head;
+
+    // Warm start
+    std::vector<int> initial_tour;
+    bool use_cutoff;
+    double cutoff;
+
+    // Cost matrix of the model, for pricing and solution validation
+    std::vector<std::vector<double>> arc_costs;
+
+    // Sparse mode: allowed arcs (empty = complete graph) and pricing state
+    std::vector<std::vector<char>> candidate;
+    std::vector<double> dual_out, dual_in, dual_flow;
+    double lp_bound;
+    static constexpr double PRICING_EPS = 1e-6;
+
+    // Minimum violation for fractional SECs to be added as user cuts
+    static constexpr double CUT_VIOLATION = 0.01;
 
     void setupVariables(CEnv env, Prob lp, int N, const std::vector<std::vector<double>>& costs);
     void setupConstraints(CEnv env, Prob lp, int N);
-    void setupFlowConservation(CEnv env, Prob lp, int N);
-    void setupAssignmentConstraints(CEnv env, Prob lp, int N);
-    void setupLinkingConstraints(CEnv env, Prob lp, int N);
+    void setupFlowConservation(RowBuffer& rows, int N);
+    void setupAssignmentConstraints(RowBuffer& rows, int N);
+    void setupLinkingConstraints(RowBuffer& rows, int N);
+    void setupDegreeConstraints(RowBuffer& rows, int N);
+
+    // Lazy SEC separation
+    static int CPXPUBLIC subtourCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextid,
+        void* userhandle);
+    int separateCandidate(CPXCALLBACKCONTEXTptr context) const;
+    int separateRelaxation(CPXCALLBACKCONTEXTptr context) const;
+    void addSubtourCut(const std::vector<int>& subset, RowBuffer& cuts) const;
+    std::vector<std::vector<double>> undirectedSupport(const std::vector<double>& y) const;
+
+    void addMipStart(CEnv env, Prob lp) const;
+    std::vector<int> extractTour(const std::vector<double>& y, std::string& issue) const;
+    void collectResult(CEnv env, CProb lp, SolveResult& result) const;
+
+    bool isArc(int i, int j) const { return i != j && (candidate.empty() || candidate[i][j]); }
+    void solvePricingLP(Env env, int N);
+    double reducedCost(int i, int j) const;
+    int addArcsBelow(double threshold);
+    void rebuildModel(Env env, Prob lp, int N);
 
 public:
-    TSPModel() = default;
-    void createModel(CEnv env, Prob lp, int N, const std::vector<std::vector<double>>& costs);
-    bool solve(CEnv env, Prob lp, double& objval, std::vector<int>& tour);
+    explicit TSPModel(Formulation formulation = Formulation::GAVISH_GRAVES,
+        bool variable_names = false)
+        : use_names(variable_names), formulation(formulation), num_cols(0), num_arcs(0), first_arc(0),
+          use_cutoff(false), cutoff(0.0), lp_bound(0.0) {}
+    void setVariableNames(bool enabled) { use_names = enabled; }
+    Formulation getFormulation() const { return formulation; }
+
+    // Tour over all N nodes (any rotation), used as MIP start by solve()
+    void setInitialTour(const std::vector<int>& tour);
+    // Nodes with bound above `value` are discarded; pass a known tour cost
+    void setCutoff(double value) { use_cutoff = true; cutoff = value; }
+    void clearCutoff() { use_cutoff = false; }
+
+    // Sparse mode: only arcs with arcs[i][j] != 0 get variables, the rest are
+    // priced in as needed. Set before createModel()
+    void setCandidateArcs(const std::vector<std::vector<char>>& arcs) { candidate = arcs; }
+    int getArcCount() const { return num_arcs; }
+
+    void createModel(Env env, Prob lp, int N, const std::vector<std::vector<double>>& costs);
+    // New costs for the same N: only the objective changes (CPXchgobj), so
+    // rows, columns and callbacks are kept. Stale MIP starts, the initial
+    // tour and the cutoff are dropped. Not available in sparse mode, whose
+    // arcs depend on costs
+    void updateCosts(Env env, Prob lp, const std::vector<std::vector<double>>& costs);
+    int getNodeCount() const { return static_cast<int>(map_y.size()); }
+    SolveResult solve(Env env, Prob lp);
     void printSolution(const std::vector<double>& solution, int N);
 };
 
@@ -0,0 +1,44 @@
+/**
+* @file solve_result.h
+* @brief Solver-independent result types
+*
+* Shared by the CPLEX model (TSPModel, BatchSolver) and the CPLEX-free
+* ExactSolver, so reporting code builds with either backend.
+*/
+
+#ifndef SOLVE_RESULT_H
+#define SOLVE_RESULT_H
+
+#include <vector>
+#include <string>
+
+// Outcome of a single exact solve
+struct SolveResult {
+    int status = 0;              // CPXgetstat code (0 for the in-tree solver)
+    std::string status_text;
+    bool has_solution = false;   // an incumbent exists, possibly time-limited
+    bool optimal = false;
+    double objval = 0.0;
+    double best_bound = 0.0;
+    double gap = 0.0;            // relative gap, percent
+    long nodes = 0;              // branch-and-bound nodes
+    double solve_time = 0.0;     // seconds
+    std::vector<int> tour;       // starts at node 0
+    double tour_cost = 0.0;      // recomputed from the cost matrix
+    bool valid = false;          // tour is a Hamiltonian cycle matching objval
+    std::string issue;           // why the tour is not valid
+};
+
+// One instance of a batch run
+struct BatchResult {
+    std::string name;
+    std::string method;        // formulation or algorithm used
+    int nodes = 0;
+    int threads = 0;
+    double setup_time = 0.0;   // seconds
+    int arcs = 0;
+    SolveResult solution;
+    std::string error;         // set when the job threw
+};
+
+#endif /* SOLVE_RESULT_H */
@@ -0,0 +1,37 @@
+/**
+* @file subtour_separation.h
+* @brief Separation routines for subtour elimination constraints (SEC)
+*
+* Graph routines used by the lazy-constraint formulation of TSPModel, kept
+* free of CPLEX types so they can be reused by other solvers:
+* - connectedComponents(): components of the support graph of a (possibly
+*   fractional) solution; for integer solutions every component but a
+*   spanning one is a violated subtour
+* - minimumCut(): Stoer-Wagner global minimum cut, O(N^3), used to find the
+*   most violated SEC of a fractional LP point
+*
+* Both operate on a symmetric capacity matrix w[i][j] = y_ij + y_ji
+* (undirected view of the arc values).
+*/
+
+#ifndef SUBTOUR_SEPARATION_H
+#define SUBTOUR_SEPARATION_H
+
+#include <vector>
+
+namespace SubtourSeparation {
+
+    // Components of the graph with edges {i,j} where w[i][j] > eps
+    std::vector<std::vector<int>> connectedComponents(
+        const std::vector<std::vector<double>>& w, double eps = 1e-6);
+
+    /**
+    * Global minimum cut of the undirected graph w. Returns the cut weight and
+    * stores one shore of the cut (the other is its complement) in `shore`.
+    * For N < 2 returns +infinity and leaves `shore` empty.
+    */
+    double minimumCut(const std::vector<std::vector<double>>& w, std::vector<int>& shore);
+
+}
+
+#endif /* SUBTOUR_SEPARATION_H */
@@ -0,0 +1,94 @@
+/**
+* @file thread_pool.h
+* @brief Fixed-size worker pool for independent tasks
+*
+* Small header-only pool used by the batch stages (instance generation,
+* calibration, exact solves). Tasks are executed in FIFO order by a fixed
+* set of workers; submit() returns a std::future so callers can collect
+* results in submission order, which keeps aggregated output deterministic
+* regardless of scheduling.
+*/
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+class ThreadPool {
+public:
+    // workers == 0 selects one worker per hardware thread
+    explicit ThreadPool(unsigned workers = 0) : stopping(false) {
+        if (workers == 0) workers = defaultWorkers();
+        threads.reserve(workers);
+        for (unsigned i = 0; i < workers; i++) {
+            threads.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (auto& t : threads) {
+            t.join();
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    template <typename F>
+    auto submit(F&& task) -> std::future<typename std::invoke_result<F>::type> {
+        using Result = typename std::invoke_result<F>::type;
+        auto packaged = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> result = packaged->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) throw std::runtime_error("submit on stopped ThreadPool");
+            tasks.emplace([packaged] { (*packaged)(); });
+        }
+        wake.notify_one();
+        return result;
+    }
+
+    unsigned size() const { return static_cast<unsigned>(threads.size()); }
+
+    static unsigned defaultWorkers() {
+        unsigned hw = std::thread::hardware_concurrency();
+        return hw ? hw : 1;
+    }
+
+private:
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping;
+
+    void workerLoop() {
+        for (;;) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;  // stopping and drained
+                task = std::move(tasks.front());
+                tasks.pop();
+            }
+            task();
+        }
+    }
+};
+
+#endif /* THREAD_POOL_H */
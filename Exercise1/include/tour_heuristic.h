@@ -0,0 +1,33 @@
+/**
+* @file tour_heuristic.h
+* @brief Construction and local search heuristics for warm-starting the MIP
+*
+* A quick feasible tour lets CPLEX start with an incumbent instead of
+* searching for one, so nodes are pruned from the first branch on:
+* - nearestNeighbour(): greedy construction from node 0, O(N^2)
+* - twoOpt(): first-improvement 2-opt until no improving move is left
+*
+* Costs may be asymmetric; the 2-opt delta then includes the reversed
+* segment, which is skipped for symmetric matrices.
+*/
+
+#ifndef TOUR_HEURISTIC_H
+#define TOUR_HEURISTIC_H
+
+#include <vector>
+
+namespace TourHeuristic {
+
+    std::vector<int> nearestNeighbour(const std::vector<std::vector<double>>& costs);
+
+    // Improves `tour` in place, returns its new cost
+    double twoOpt(const std::vector<std::vector<double>>& costs, std::vector<int>& tour);
+
+    double tourCost(const std::vector<std::vector<double>>& costs, const std::vector<int>& tour);
+
+    // Nearest neighbour followed by 2-opt
+    std::vector<int> initialTour(const std::vector<std::vector<double>>& costs);
+
+}
+
+#endif /* TOUR_HEURISTIC_H */
@@ -0,0 +1,60 @@
+/**
+* @file tsp_session.h
+* @brief Long-lived CPLEX session for repeated solves
+*
+* Opening a CPLEX environment checks out a license and initializes the
+* library, which costs more than solving a small board. TSPSession keeps one
+* environment and one problem alive across solve() calls:
+* - Same number of holes as the previous call: the model is kept and only
+*   the objective is updated (TSPModel::updateCosts, a single CPXchgobj);
+*   the previous tour, still feasible, becomes the MIP start
+* - Different size or formulation: the problem is rebuilt in the same
+*   environment
+*
+* Meant for what-if analyses where hole positions shift slightly between
+* runs. A session is not thread-safe; use one per thread.
+*/
+
+#ifndef TSP_SESSION_H
+#define TSP_SESSION_H
+
+#include <cpxmacro.h>
+#include <model.h>
+#include <memory>
+#include <vector>
+
+class TSPSession {
+public:
+    explicit TSPSession(Formulation formulation = Formulation::GAVISH_GRAVES);
+    TSPSession(const TSPSession&) = delete;
+    TSPSession& operator=(const TSPSession&) = delete;
+    ~TSPSession();
+
+    // Applied to the environment, kept across solves
+    void setTimeLimit(double seconds);
+    void setThreads(int threads);
+
+    void setFormulation(Formulation f) { formulation = f; }
+    // Use the previous tour as MIP start when the size is unchanged (default on)
+    void setReuseTour(bool enabled) { reuse_tour = enabled; }
+
+    SolveResult solve(const std::vector<std::vector<double>>& costs);
+
+    int getRebuilds() const { return rebuilds; }
+    int getUpdates() const { return updates; }
+    Env environment() const { return env; }
+
+private:
+    Env env;
+    Prob lp;
+    std::unique_ptr<TSPModel> model;   // registered as callback handle, must not move
+    Formulation formulation;
+    bool reuse_tour;
+    std::vector<int> last_tour;
+    int rebuilds;
+    int updates;
+
+    void rebuild(const std::vector<std::vector<double>>& costs);
+};
+
+#endif /* TSP_SESSION_H */
@@ -0,0 +1,143 @@
+// batch_solver.cpp
+#include <batch_solver.h>
+#include <algorithm>
+#include <numeric>
+#include <thread>
+#include <condition_variable>
+#include <chrono>
+
+EnvPool::~EnvPool() {
+    for (Env env : all) {
+        CPXcloseCPLEX(&env);
+    }
+}
+
+Env EnvPool::acquire() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!idle.empty()) {
+            Env env = idle.back();
+            idle.pop_back();
+            return env;
+        }
+    }
+
+    DECL_ENV(env);
+    std::lock_guard<std::mutex> lock(mutex);
+    all.push_back(env);
+    return env;
+}
+
+void EnvPool::release(Env env) {
+    // Parameters set by the last solve (threads, time limit, cutoff) must not leak
+    CPXsetdefaults(env);
+    std::lock_guard<std::mutex> lock(mutex);
+    idle.push_back(env);
+}
+
+std::size_t EnvPool::opened() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return all.size();
+}
+
+BatchSolver::BatchSolver(unsigned total_threads, unsigned max_threads_per_solve)
+    : total_threads(total_threads ? total_threads : std::max(1u, std::thread::hardware_concurrency())),
+      max_threads_per_solve(max_threads_per_solve) {}
+
+int BatchSolver::threadsFor(int nodes) const {
+    // Small models gain little from parallel branch-and-bound; large ones
+    // leave SMALL_JOB_SHARE of the cores so small jobs run alongside
+    unsigned reserved = total_threads > 1
+        ? std::max(1u, static_cast<unsigned>(total_threads * SMALL_JOB_SHARE)) : 0u;
+    unsigned threads = nodes <= 20 ? 1 : nodes <= 35 ? 2 : total_threads - reserved;
+    if (max_threads_per_solve) threads = std::min(threads, max_threads_per_solve);
+    return static_cast<int>(std::min(threads, total_threads));
+}
+
+BatchResult BatchSolver::solveOne(const BatchJob& job, int threads) {
+    BatchResult result;
+    result.name = job.name;
+    result.nodes = static_cast<int>(job.costs.size());
+    result.threads = threads;
+    result.method = formulationName(job.formulation);
+
+    Env env = nullptr;
+    try {
+        env = pool.acquire();
+        CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_THREADS, threads);
+        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_TILIM, job.time_limit);
+
+        DECL_PROB(env, lp);
+        try {
+            auto model_start = std::chrono::steady_clock::now();
+            TSPModel model(job.formulation);
+            if (job.prepare) job.prepare(model, job);
+            model.createModel(env, lp, result.nodes, job.costs);
+            auto solve_start = std::chrono::steady_clock::now();
+
+            result.setup_time = std::chrono::duration<double>(solve_start - model_start).count();
+            result.solution = model.solve(env, lp);
+            result.arcs = model.getArcCount();
+        }
+        catch (...) {
+            CPXfreeprob(env, &lp);
+            throw;
+        }
+        CPXfreeprob(env, &lp);
+    }
+    catch (std::exception& e) {
+        result.error = e.what();
+    }
+
+    if (env) pool.release(env);
+    return result;
+}
+
+std::vector<BatchResult> BatchSolver::run(const std::vector<BatchJob>& jobs) {
+    std::vector<BatchResult> results(jobs.size());
+
+    // Longest processing time first; MIP effort grows quickly with N
+    std::vector<std::size_t> pending(jobs.size());
+    std::iota(pending.begin(), pending.end(), 0);
+    std::stable_sort(pending.begin(), pending.end(), [&](std::size_t a, std::size_t b) {
+        return jobs[a].costs.size() > jobs[b].costs.size();
+    });
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    int idle_threads = static_cast<int>(total_threads);
+    std::vector<std::thread> workers;
+    workers.reserve(jobs.size());
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!pending.empty()) {
+        // Largest pending job that fits the idle cores (backfilling)
+        auto next = std::find_if(pending.begin(), pending.end(), [&](std::size_t j) {
+            return threadsFor(static_cast<int>(jobs[j].costs.size())) <= idle_threads;
+        });
+        if (next == pending.end()) {
+            finished.wait(lock);
+            continue;
+        }
+
+        std::size_t j = *next;
+        pending.erase(next);
+        int threads = threadsFor(static_cast<int>(jobs[j].costs.size()));
+        idle_threads -= threads;
+
+        workers.emplace_back([this, &jobs, &results, &mutex, &finished, &idle_threads, j, threads] {
+            results[j] = solveOne(jobs[j], threads);
+            {
+                std::lock_guard<std::mutex> guard(mutex);
+                idle_threads += threads;
+            }
+            finished.notify_one();
+        });
+    }
+    lock.unlock();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return results;
+}
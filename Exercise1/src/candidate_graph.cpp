@@ -0,0 +1,143 @@
+// candidate_graph.cpp
+#include <candidate_graph.h>
+#include <algorithm>
+#include <numeric>
+
+namespace CandidateGraph {
+
+    namespace {
+
+        struct Triangle {
+            int a, b, c;   // counter-clockwise
+        };
+
+        double orient(const std::vector<double>& xs, const std::vector<double>& ys,
+            int a, int b, int c) {
+            return (xs[b] - xs[a]) * (ys[c] - ys[a]) - (ys[b] - ys[a]) * (xs[c] - xs[a]);
+        }
+
+        // > 0 when d lies strictly inside the circumcircle of ccw triangle abc
+        double inCircle(const std::vector<double>& xs, const std::vector<double>& ys,
+            const Triangle& t, int d) {
+            double adx = xs[t.a] - xs[d], ady = ys[t.a] - ys[d];
+            double bdx = xs[t.b] - xs[d], bdy = ys[t.b] - ys[d];
+            double cdx = xs[t.c] - xs[d], cdy = ys[t.c] - ys[d];
+            double ad = adx * adx + ady * ady;
+            double bd = bdx * bdx + bdy * bdy;
+            double cd = cdx * cdx + cdy * cdy;
+            return adx * (bdy * cd - bd * cdy)
+                - ady * (bdx * cd - bd * cdx)
+                + ad * (bdx * cdy - bdy * cdx);
+        }
+
+        void link(Arcs& arcs, int i, int j) {
+            arcs[i][j] = 1;
+            arcs[j][i] = 1;
+        }
+
+    }
+
+    Arcs empty(int N) {
+        return Arcs(N, std::vector<char>(N, 0));
+    }
+
+    void addNearest(Arcs& arcs, const std::vector<std::vector<double>>& costs, int k) {
+        const int N = static_cast<int>(costs.size());
+        k = std::min(k, N - 1);
+        if (k <= 0) return;
+
+        std::vector<int> order(N);
+        for (int i = 0; i < N; i++) {
+            std::iota(order.begin(), order.end(), 0);
+            order.erase(order.begin() + i);
+            std::partial_sort(order.begin(), order.begin() + k, order.end(),
+                [&](int a, int b) { return costs[i][a] < costs[i][b]; });
+            for (int r = 0; r < k; r++) {
+                link(arcs, i, order[r]);
+            }
+            order.resize(N);
+        }
+    }
+
+    void addDelaunay(Arcs& arcs, const std::vector<double>& xs_in, const std::vector<double>& ys_in) {
+        const int N = static_cast<int>(xs_in.size());
+        if (N < 2) return;
+        if (N == 2) {
+            link(arcs, 0, 1);
+            return;
+        }
+
+        // Bowyer-Watson: insert points one by one into a super triangle and
+        // re-triangulate the cavity of triangles whose circumcircle contains it
+        std::vector<double> xs = xs_in, ys = ys_in;
+        double min_x = *std::min_element(xs.begin(), xs.end());
+        double max_x = *std::max_element(xs.begin(), xs.end());
+        double min_y = *std::min_element(ys.begin(), ys.end());
+        double max_y = *std::max_element(ys.begin(), ys.end());
+        double span = std::max({ max_x - min_x, max_y - min_y, 1.0 });
+        double mid_x = 0.5 * (min_x + max_x), mid_y = 0.5 * (min_y + max_y);
+
+        // Super vertices far enough away that no hull edge is lost to them
+        const int s0 = N, s1 = N + 1, s2 = N + 2;
+        xs.push_back(mid_x - 1e4 * span); ys.push_back(mid_y - span);
+        xs.push_back(mid_x + 1e4 * span); ys.push_back(mid_y - span);
+        xs.push_back(mid_x);              ys.push_back(mid_y + 1e4 * span);
+
+        std::vector<Triangle> triangles = { { s0, s1, s2 } };
+        std::vector<Triangle> kept;
+        std::vector<std::pair<int, int>> boundary;
+
+        for (int p = 0; p < N; p++) {
+            kept.clear();
+            boundary.clear();
+            for (const Triangle& t : triangles) {
+                if (inCircle(xs, ys, t, p) > 0.0) {
+                    // Directed cavity edges; an interior edge appears in both
+                    // directions and cancels out below
+                    boundary.push_back({ t.a, t.b });
+                    boundary.push_back({ t.b, t.c });
+                    boundary.push_back({ t.c, t.a });
+                }
+                else {
+                    kept.push_back(t);
+                }
+            }
+
+            std::sort(boundary.begin(), boundary.end());
+            for (const auto& e : boundary) {
+                if (std::binary_search(boundary.begin(), boundary.end(),
+                        std::make_pair(e.second, e.first))) {
+                    continue;
+                }
+                // Skip degenerate (collinear) fans
+                if (orient(xs, ys, e.first, e.second, p) > 0.0) {
+                    kept.push_back({ e.first, e.second, p });
+                }
+            }
+            triangles.swap(kept);
+        }
+
+        for (const Triangle& t : triangles) {
+            int v[3] = { t.a, t.b, t.c };
+            for (int e = 0; e < 3; e++) {
+                int i = v[e], j = v[(e + 1) % 3];
+                if (i < N && j < N) link(arcs, i, j);
+            }
+        }
+    }
+
+    void addTour(Arcs& arcs, const std::vector<int>& tour) {
+        for (std::size_t p = 0; p < tour.size(); p++) {
+            link(arcs, tour[p], tour[(p + 1) % tour.size()]);
+        }
+    }
+
+    long count(const Arcs& arcs) {
+        long total = 0;
+        for (const auto& row : arcs) {
+            total += std::count(row.begin(), row.end(), 1);
+        }
+        return total;
+    }
+
+}
@@ -0,0 +1,522 @@
+// exact_solver.cpp
+#include <exact_solver.h>
+#include <thread_pool.h>
+#include <tour_heuristic.h>
+#include <cost_matrix.h>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    double elapsed(Clock::time_point start) {
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+    // Edge states of a branch-and-bound node
+    enum EdgeState : char { FREE = 0, FORCED_IN = 1, FORCED_OUT = 2 };
+
+    struct Node {
+        std::vector<char> state;    // n x n, symmetric
+        std::vector<double> pi;     // penalties to warm-start the subgradient
+        int depth;
+    };
+
+    struct OneTree {
+        double weight;                          // sum of c_ij + pi_i + pi_j
+        std::vector<int> degree;
+        std::vector<std::pair<int, int>> edges;
+        bool feasible;                          // no FORCED_OUT edge was needed
+    };
+
+    class BranchAndBound {
+    public:
+        BranchAndBound(const std::vector<std::vector<double>>& costs, unsigned threads,
+            double time_limit)
+            : n(costs.size()), costs(costs), cost(n * n), threads(threads),
+              time_limit(time_limit), stop(false), node_count(0) {
+
+            double max_cost = 0.0;
+            integral = true;
+            for (int i = 0; i < n; i++) {
+                for (int j = 0; j < n; j++) {
+                    cost[i * n + j] = costs[i][j];
+                    max_cost = std::max(max_cost, std::abs(costs[i][j]));
+                    if (costs[i][j] != std::floor(costs[i][j])) integral = false;
+                }
+            }
+            // Forced edges are ordered first/last by Prim, never summed
+            big = 4.0 * n * (max_cost + 1.0);
+        }
+
+        SolveResult run() {
+            start = Clock::now();
+
+            // Incumbent from nearest neighbour + 2-opt
+            best_tour = TourHeuristic::initialTour(costs);
+            upper.store(TourHeuristic::tourCost(costs, best_tour));
+
+            Node root;
+            root.state.assign(n * n, FREE);
+            root.pi.assign(n, 0.0);
+            root.depth = 0;
+
+            std::vector<Node> frontier;
+            root_bound = process(root, ROOT_ITERATIONS, frontier);
+
+            // Breadth-first until every worker has a few subtrees
+            const std::size_t target = 4 * static_cast<std::size_t>(threads);
+            while (!frontier.empty() && frontier.size() < target && !stop) {
+                std::vector<Node> next;
+                for (auto& node : frontier) {
+                    process(node, NODE_ITERATIONS, next);
+                }
+                frontier.swap(next);
+            }
+
+            if (!frontier.empty() && !stop) {
+                ThreadPool pool(threads);
+                std::vector<std::future<void>> pending;
+                for (auto& node : frontier) {
+                    pending.push_back(pool.submit([this, &node] { depthFirst(std::move(node)); }));
+                }
+                for (auto& f : pending) f.get();
+            }
+
+            SolveResult result;
+            result.has_solution = true;
+            result.optimal = !stop;
+            result.status_text = stop ? "time limit exceeded, incumbent returned" : "optimal";
+            result.objval = upper.load();
+            result.best_bound = result.optimal ? result.objval : std::min(root_bound, result.objval);
+            result.gap = result.objval > 0.0 ? (result.objval - result.best_bound) / result.objval * 100.0 : 0.0;
+            result.nodes = node_count.load();
+            result.tour = best_tour;
+            return result;
+        }
+
+    private:
+        static constexpr int ROOT_ITERATIONS = 1000;
+        static constexpr int NODE_ITERATIONS = 50;
+
+        const int n;
+        const std::vector<std::vector<double>>& costs;
+        std::vector<double> cost;   // row-major copy
+        double big;
+        bool integral;              // integer costs: bounds can be rounded up
+        unsigned threads;
+        double time_limit;
+        Clock::time_point start;
+
+        std::atomic<bool> stop;
+        std::atomic<long> node_count;
+        std::atomic<double> upper;
+        std::mutex incumbent_mutex;
+        std::vector<int> best_tour;
+        double root_bound;
+
+        double adjusted(const std::vector<char>& state, const std::vector<double>& pi, int i, int j) const {
+            double w = cost[i * n + j] + pi[i] + pi[j];
+            char s = state[i * n + j];
+            return s == FORCED_IN ? w - big : s == FORCED_OUT ? w + big : w;
+        }
+
+        // 1-tree under penalties: Prim on 1..n-1 plus the two best edges at 0.
+        // Selection uses the forced-edge adjustment, the weight does not
+        OneTree oneTree(const std::vector<char>& state, const std::vector<double>& pi) const {
+            const double inf = std::numeric_limits<double>::infinity();
+            OneTree tree;
+            tree.weight = 0.0;
+            tree.degree.assign(n, 0);
+            tree.edges.clear();
+            tree.edges.reserve(n);
+            tree.feasible = true;
+
+            std::vector<double> key(n, inf);
+            std::vector<int> parent(n, -1);
+            std::vector<char> in_tree(n, 0);
+            key[1] = 0.0;
+
+            for (int step = 1; step < n; step++) {
+                int u = -1;
+                for (int v = 1; v < n; v++) {
+                    if (!in_tree[v] && (u < 0 || key[v] < key[u])) u = v;
+                }
+                in_tree[u] = 1;
+                if (parent[u] >= 0) {
+                    int p = parent[u];
+                    if (state[p * n + u] == FORCED_OUT) tree.feasible = false;
+                    tree.weight += cost[p * n + u] + pi[p] + pi[u];
+                    tree.degree[p]++;
+                    tree.degree[u]++;
+                    tree.edges.push_back({ p, u });
+                }
+                for (int v = 1; v < n; v++) {
+                    if (in_tree[v]) continue;
+                    double w = adjusted(state, pi, u, v);
+                    if (w < key[v]) {
+                        key[v] = w;
+                        parent[v] = u;
+                    }
+                }
+            }
+
+            int first = -1, second = -1;
+            for (int v = 1; v < n; v++) {
+                double w = adjusted(state, pi, 0, v);
+                if (first < 0 || w < adjusted(state, pi, 0, first)) {
+                    second = first;
+                    first = v;
+                }
+                else if (second < 0 || w < adjusted(state, pi, 0, second)) {
+                    second = v;
+                }
+            }
+            for (int v : { first, second }) {
+                if (state[v] == FORCED_OUT) tree.feasible = false;
+                tree.weight += cost[v] + pi[0] + pi[v];
+                tree.degree[0]++;
+                tree.degree[v]++;
+                tree.edges.push_back({ 0, v });
+            }
+            return tree;
+        }
+
+        // Subgradient ascent from node.pi; returns the best bound and leaves
+        // node.pi at the penalties that produced it, `tree` at their 1-tree
+        double bound(Node& node, int iterations, OneTree& tree) const {
+            const double target = upper.load();
+            double best = -std::numeric_limits<double>::infinity();
+            std::vector<double> pi = node.pi;
+            double lambda = node.depth == 0 ? 2.0 : 0.5;
+            const int period = node.depth == 0 ? std::max(10, n / 2) : 5;
+            int since_improvement = 0;
+
+            for (int it = 0; it < iterations && lambda > 1e-5; it++) {
+                OneTree current = oneTree(node.state, pi);
+                if (!current.feasible) {
+                    tree = current;
+                    return std::numeric_limits<double>::infinity();
+                }
+
+                double sum_pi = 0.0;
+                for (double p : pi) sum_pi += p;
+                double value = current.weight - 2.0 * sum_pi;
+
+                double norm = 0.0;
+                for (int v = 0; v < n; v++) {
+                    double g = current.degree[v] - 2;
+                    norm += g * g;
+                }
+
+                if (value > best + 1e-9) {
+                    best = value;
+                    node.pi = pi;
+                    tree = current;
+                    since_improvement = 0;
+                }
+                else if (++since_improvement >= period) {
+                    lambda *= 0.5;
+                    since_improvement = 0;
+                }
+
+                if (norm == 0.0 || prunable(best)) break;
+
+                double step = lambda * std::max(target - value, 1e-6 * std::abs(target)) / norm;
+                for (int v = 0; v < n; v++) {
+                    pi[v] += step * (current.degree[v] - 2);
+                }
+            }
+            return best;
+        }
+
+        void offerTour(const OneTree& tree) {
+            // All degrees 2: the 1-tree is a tour, walk it from 0
+            std::vector<std::vector<int>> adjacent(n);
+            for (const auto& e : tree.edges) {
+                adjacent[e.first].push_back(e.second);
+                adjacent[e.second].push_back(e.first);
+            }
+            std::vector<int> tour = { 0 };
+            int previous = -1, current = 0;
+            while (static_cast<int>(tour.size()) < n) {
+                int next = adjacent[current][0] == previous ? adjacent[current][1] : adjacent[current][0];
+                tour.push_back(next);
+                previous = current;
+                current = next;
+            }
+
+            double value = TourHeuristic::tourCost(costs, tour);
+            std::lock_guard<std::mutex> lock(incumbent_mutex);
+            if (value < upper.load()) {
+                upper.store(value);
+                best_tour = tour;
+            }
+        }
+
+        // Fixes edge (a,b) in; nodes reaching two forced edges lose all
+        // others. False when the child is infeasible
+        bool include(std::vector<char>& state, int a, int b) const {
+            if (state[a * n + b] == FORCED_OUT) return false;
+            state[a * n + b] = state[b * n + a] = FORCED_IN;
+
+            for (int v : { a, b }) {
+                int forced = 0;
+                for (int w = 0; w < n; w++) forced += state[v * n + w] == FORCED_IN;
+                if (forced > 2) return false;
+                if (forced == 2) {
+                    for (int w = 0; w < n; w++) {
+                        if (w != v && state[v * n + w] == FREE) {
+                            state[v * n + w] = state[w * n + v] = FORCED_OUT;
+                        }
+                    }
+                }
+            }
+            return !closesSubtour(state);
+        }
+
+        // Forced edges must stay a forest unless they form a full tour
+        bool closesSubtour(const std::vector<char>& state) const {
+            std::vector<int> root(n);
+            for (int v = 0; v < n; v++) root[v] = v;
+            auto find = [&](int v) {
+                while (root[v] != v) v = root[v] = root[root[v]];
+                return v;
+            };
+            int forced = 0;
+            bool cycle = false;
+            for (int i = 0; i < n; i++) {
+                for (int j = i + 1; j < n; j++) {
+                    if (state[i * n + j] != FORCED_IN) continue;
+                    forced++;
+                    int ri = find(i), rj = find(j);
+                    if (ri == rj) cycle = true;
+                    else root[ri] = rj;
+                }
+            }
+            return cycle && forced < n;
+        }
+
+        void exclude(std::vector<char>& state, int a, int b) const {
+            state[a * n + b] = state[b * n + a] = FORCED_OUT;
+        }
+
+        bool prunable(double value) const {
+            double limit = upper.load();
+            if (integral) return std::ceil(value - 1e-6) >= limit;
+            return value >= limit - 1e-9 * std::max(1.0, std::abs(value));
+        }
+
+        // Bounds one node and appends its children
+        double process(Node& node, int iterations, std::vector<Node>& children) {
+            node_count++;
+            if (elapsed(start) > time_limit) {
+                stop = true;
+                return -std::numeric_limits<double>::infinity();
+            }
+
+            OneTree tree;
+            double value = bound(node, iterations, tree);
+            if (prunable(value)) return value;
+
+            // Branch at the node with the highest 1-tree degree
+            int v = 0;
+            for (int u = 1; u < n; u++) {
+                if (tree.degree[u] > tree.degree[v]) v = u;
+            }
+            if (tree.degree[v] <= 2) {
+                offerTour(tree);
+                return value;
+            }
+
+            std::vector<int> free_edges;
+            int forced = 0;
+            for (const auto& e : tree.edges) {
+                if (e.first != v && e.second != v) continue;
+                int w = e.first == v ? e.second : e.first;
+                if (node.state[v * n + w] == FREE) free_edges.push_back(w);
+                else if (node.state[v * n + w] == FORCED_IN) forced++;
+            }
+            if (free_edges.empty()) return value;
+
+            // Volgenant-Jonker: with e1, e2 free tree edges at v
+            //   e1 out | e1 in, e2 out | e1 in, e2 in (if v had no forced edge)
+            int e1 = free_edges[0];
+            Node out = { node.state, node.pi, node.depth + 1 };
+            exclude(out.state, v, e1);
+            children.push_back(std::move(out));
+
+            if (forced == 1 || free_edges.size() == 1) {
+                Node in = { node.state, node.pi, node.depth + 1 };
+                if (include(in.state, v, e1)) children.push_back(std::move(in));
+                return value;
+            }
+
+            int e2 = free_edges[1];
+            Node mixed = { node.state, node.pi, node.depth + 1 };
+            if (include(mixed.state, v, e1)) {
+                exclude(mixed.state, v, e2);
+                children.push_back(std::move(mixed));
+            }
+            Node both = { node.state, node.pi, node.depth + 1 };
+            if (include(both.state, v, e1) && include(both.state, v, e2)) {
+                children.push_back(std::move(both));
+            }
+            return value;
+        }
+
+        void depthFirst(Node root) {
+            std::vector<Node> stack;
+            stack.push_back(std::move(root));
+            while (!stack.empty() && !stop) {
+                Node node = std::move(stack.back());
+                stack.pop_back();
+                process(node, NODE_ITERATIONS, stack);
+            }
+        }
+    };
+
+}
+
+ExactSolver::ExactSolver(unsigned threads, double time_limit)
+    : threads(threads ? threads : ThreadPool::defaultWorkers()), time_limit(time_limit) {}
+
+void ExactSolver::setThreads(unsigned count) {
+    threads = count ? count : ThreadPool::defaultWorkers();
+}
+
+std::string ExactSolver::method(int N) {
+    if (N <= DP_MAX_NODES) return "Held-Karp dynamic programming";
+    if (N <= BRANCH_MAX_NODES) return "1-tree branch-and-bound";
+    return "unsupported";
+}
+
+SolveResult ExactSolver::solve(const std::vector<std::vector<double>>& costs) const {
+    const int N = costs.size();
+    if (!supports(N)) {
+        throw std::invalid_argument("Exact solver supports up to " +
+            std::to_string(BRANCH_MAX_NODES) + " nodes, got " + std::to_string(N));
+    }
+
+    auto start = Clock::now();
+    SolveResult result = N <= DP_MAX_NODES ? solveDynamicProgramming(costs) : solveBranchAndBound(costs);
+    result.solve_time = elapsed(start);
+
+    // Same validation as TSPModel::solve
+    std::vector<char> seen(N, 0);
+    result.valid = static_cast<int>(result.tour.size()) == N && (N == 0 || result.tour[0] == 0);
+    for (int v : result.tour) {
+        if (v < 0 || v >= N || seen[v]) result.valid = false;
+        else seen[v] = 1;
+    }
+    if (!result.valid) {
+        result.issue = "tour is not a permutation starting at the depot";
+        return result;
+    }
+    result.tour_cost = TourHeuristic::tourCost(costs, result.tour);
+    if (std::abs(result.tour_cost - result.objval) > 1e-6 * std::max(1.0, std::abs(result.objval))) {
+        result.valid = false;
+        result.issue = "tour cost " + std::to_string(result.tour_cost) +
+            " differs from objective " + std::to_string(result.objval);
+    }
+    return result;
+}
+
+SolveResult ExactSolver::solveDynamicProgramming(const std::vector<std::vector<double>>& costs) const {
+    const int N = costs.size();
+    SolveResult result;
+    result.has_solution = true;
+    result.optimal = true;
+    result.status_text = "optimal";
+
+    if (N <= 3) {
+        for (int v = 0; v < N; v++) result.tour.push_back(v);
+        result.objval = result.best_bound = TourHeuristic::tourCost(costs, result.tour);
+        return result;
+    }
+
+    // D[S * m + j]: cheapest path 0 -> ... -> j+1 visiting exactly the
+    // nodes of S (bit j = node j+1), with j in S
+    const int m = N - 1;
+    const std::size_t subsets = std::size_t(1) << m;
+    const double inf = std::numeric_limits<double>::infinity();
+    std::vector<double> D(subsets * m, inf);
+    for (int j = 0; j < m; j++) {
+        D[(std::size_t(1) << j) * m + j] = costs[0][j + 1];
+    }
+
+    // Subsets of size k only read size k-1, so each layer splits across workers
+    ThreadPool pool(threads);
+    const std::size_t chunk = (subsets + pool.size() - 1) / pool.size();
+    for (int k = 2; k <= m; k++) {
+        std::vector<std::future<void>> pending;
+        for (std::size_t begin = 0; begin < subsets; begin += chunk) {
+            std::size_t end = std::min(subsets, begin + chunk);
+            pending.push_back(pool.submit([&, begin, end, k] {
+                for (std::size_t S = begin; S < end; S++) {
+                    if (static_cast<int>(std::bitset<64>(S).count()) != k) continue;
+                    for (int j = 0; j < m; j++) {
+                        if (!(S >> j & 1)) continue;
+                        std::size_t prev = S ^ (std::size_t(1) << j);
+                        double best = inf;
+                        for (int i = 0; i < m; i++) {
+                            if (prev >> i & 1) {
+                                best = std::min(best, D[prev * m + i] + costs[i + 1][j + 1]);
+                            }
+                        }
+                        D[S * m + j] = best;
+                    }
+                }
+            }));
+        }
+        for (auto& f : pending) f.get();
+    }
+
+    // Close the cycle and walk back through the table
+    const std::size_t full = subsets - 1;
+    int last = 0;
+    double best = inf;
+    for (int j = 0; j < m; j++) {
+        double value = D[full * m + j] + costs[j + 1][0];
+        if (value < best) {
+            best = value;
+            last = j;
+        }
+    }
+
+    std::vector<int> reversed;
+    std::size_t S = full;
+    int j = last;
+    while (true) {
+        reversed.push_back(j + 1);
+        std::size_t prev = S ^ (std::size_t(1) << j);
+        if (prev == 0) break;
+        int from = -1;
+        for (int i = 0; i < m && from < 0; i++) {
+            if ((prev >> i & 1) && D[prev * m + i] + costs[i + 1][j + 1] == D[S * m + j]) from = i;
+        }
+        S = prev;
+        j = from;
+    }
+
+    result.tour.push_back(0);
+    result.tour.insert(result.tour.end(), reversed.rbegin(), reversed.rend());
+    result.objval = result.best_bound = best;
+    result.nodes = static_cast<long>(subsets);
+    return result;
+}
+
+SolveResult ExactSolver::solveBranchAndBound(const std::vector<std::vector<double>>& costs) const {
+    if (!CostMatrix::isSymmetric(costs)) {
+        throw std::invalid_argument("1-tree branch-and-bound requires symmetric costs");
+    }
+    BranchAndBound search(costs, threads, time_limit);
+    return search.run();
+}
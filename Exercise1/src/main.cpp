@@ -14,11 +14,15 @@
  *
  * Program Flow:
  * 1. Instance Generation:
+ *    - Generates all test boards in parallel via BatchGenerator, with
+ *      seed-named files and a manifest (data/manifest.csv)
  *    - Creates test boards of varying sizes (50x50 to 200x200)
  *    - Applies industry-standard manufacturing constraints
  *    - Categorizes instances by complexity (small/medium/large)
  *
  * 2. Solution Process:
+ *    - Solves the boards concurrently via BatchSolver, packing small
+ *      instances next to large ones within the core budget
  *    - Configures CPLEX parameters based on instance size
  *    - Implements adaptive time limits (10s-300s)
  *    - Tracks setup and solution times separately
@@ -35,6 +39,25 @@
  * - Large boards (150x150, ~45-50 holes)
  * - Extra large boards (200x200, ~80-85 holes)
  *
+ * Command line:
+ * --cost-model=NAME selects the travel cost (euclidean, manhattan, chebyshev,
+ * trapezoidal); see cost_model.h
+ * --formulation=lazy solves with lazy subtour elimination cuts instead of the
+ * Gavish-Graves flow model (default, --formulation=flow);
+ * --formulation=symmetric uses undirected edge variables when the costs allow
+ * --warm-start gives CPLEX a nearest-neighbour + 2-opt tour as MIP start
+ * --cutoff also uses that tour's cost as upper cutoff (implies --warm-start)
+ * --sparse builds the model on a candidate graph (5 nearest neighbours plus
+ *   Delaunay edges) and prices in missing arcs; still exact
+ * --threads=N caps the cores used by the whole batch (default: all), and
+ *   --threads-per-solve=N the CPLEX threads of a single instance
+ * --what-if=K re-solves the first board K times with slightly shifted holes
+ *   in one long-lived TSPSession instead of running the batch
+ * --backend=exact solves with the in-tree ExactSolver instead of CPLEX
+ *   (Held-Karp DP up to 20 holes, 1-tree branch-and-bound up to 100). It is
+ *   the only backend of a build without CPLEX (make NO_CPLEX=1, or cmake
+ *   -DUSE_CPLEX=OFF), where the CPLEX options are ignored
+ *
  * Performance Metrics Generated:
  * - Model setup time
  * - Solution time
@@ -48,29 +71,167 @@
 
 #include <iostream>
 #include <iomanip>
+#ifndef NO_CPLEX
 #include <cpxmacro.h>
 #include <model.h>
+#include <candidate_graph.h>
+#include <batch_solver.h>
+#include <tsp_session.h>
+#endif
 #include <data_generator.h>
+#include <batch_generator.h>
+#include <cost_model.h>
+#include <tour_heuristic.h>
+#include <exact_solver.h>
+#include <cost_matrix.h>
+#include <random>
 #include <chrono>
 #include <tuple>
-#include <direct.h>
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
+#include <sstream>
 
-int status;
-char errmsg[BUF_SIZE];
+#ifndef NO_CPLEX
+thread_local int status;
+thread_local char errmsg[BUF_SIZE];
+#endif
 
 bool createDirectoryIfNeeded(const std::string& path) {
-    return _mkdir(path.c_str()) == 0 || errno == EEXIST;
+    std::error_code error;
+    std::filesystem::create_directories(path, error);
+    return !error;
+}
+
+// Same size-based time limits for both backends
+double timeLimitFor(int N) {
+    return N <= 20 ? 10.0 :     // 10 seconds for small
+        N <= 35 ? 60.0 :        // 1 minute for medium
+        300.0;                  // 5 minutes for large
 }
 
-std::string getSizeCategory(int N) {
-    if (N <= 20) return "small";
-    if (N <= 35) return "medium";
-    return "large";
+// Solves the boards one after another with the in-tree solver; each solve
+// already spreads over all threads
+std::vector<BatchResult> solveWithExactBackend(
+    const std::vector<BatchGenerator::ManifestEntry>& manifest, unsigned threads) {
+    ExactSolver solver(threads);
+    std::vector<BatchResult> results(manifest.size());
+
+    for (std::size_t k = 0; k < manifest.size(); k++) {
+        BatchResult& result = results[k];
+        result.name = manifest[k].filename;
+        result.threads = solver.getThreads();
+        try {
+            auto load_start = std::chrono::steady_clock::now();
+            auto costs = TSPGenerator::loadFromFile(result.name);
+            int N = costs.size();
+            result.nodes = N;
+            result.method = ExactSolver::method(N);
+            result.setup_time = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - load_start).count();
+
+            solver.setTimeLimit(timeLimitFor(N));
+            result.solution = solver.solve(costs);
+        }
+        catch (std::exception& e) {
+            result.error = e.what();
+        }
+    }
+    return results;
+}
+
+#ifndef NO_CPLEX
+
+// Re-solves one board while its holes drift by up to +-0.05 mm, keeping a
+// single CPLEX session so only the objective changes between runs
+void runWhatIf(const BatchGenerator::ManifestEntry& entry, const CostModel& cost_model,
+    Formulation formulation, int runs) {
+    auto holes = TSPGenerator::generateHoles(entry.width, entry.height, entry.components, entry.seed);
+    std::mt19937 rng(entry.seed);
+    std::uniform_real_distribution<double> shift(-0.05, 0.05);
+
+    TSPSession session(formulation);
+    session.setTimeLimit(60.0);
+
+    std::cout << "\n=== What-if analysis on " << entry.filename << " (" << holes.size()
+        << " holes) ===\n\n";
+    for (int run = 0; run <= runs; run++) {
+        if (run > 0) {
+            for (auto& hole : holes) {
+                hole.x += shift(rng);
+                hole.y += shift(rng);
+            }
+        }
+        auto costs = cost_model.buildMatrix(holes);
+        SolveResult result = session.solve(costs);
+
+        std::cout << "Run " << run << ": " << (result.valid ? std::to_string(result.objval) : result.issue)
+            << " " << cost_model.units() << ", " << result.solve_time << " s, "
+            << result.nodes << " nodes (" << session.getRebuilds() << " builds, "
+            << session.getUpdates() << " updates)\n";
+    }
 }
+#endif
 
 int main(int argc, char const* argv[]) {
     try {
+        // --cost-model=euclidean|manhattan|chebyshev|trapezoidal
+        // --formulation=flow|lazy|symmetric
+        // --backend=cplex|exact
+        CostModel cost_model;
+        unsigned total_threads = 0;
+#ifndef NO_CPLEX
+        Formulation formulation = Formulation::GAVISH_GRAVES;
+        bool exact_backend = false;
+        bool warm_start = false, use_cutoff = false, sparse = false;
+        unsigned threads_per_solve = 0;
+        int what_if_runs = 0;
+#else
+        const bool exact_backend = true;
+#endif
+        for (int a = 1; a < argc; a++) {
+            std::string arg(argv[a]);
+            if (arg.rfind("--cost-model=", 0) == 0) {
+                cost_model = CostModel(CostModel::parse(arg.substr(13)));
+            }
+            else if (arg.rfind("--threads=", 0) == 0) {
+                total_threads = std::stoul(arg.substr(10));
+            }
+#ifndef NO_CPLEX
+            else if (arg == "--backend=exact") {
+                exact_backend = true;
+            }
+            else if (arg == "--backend=cplex") {
+                exact_backend = false;
+            }
+            else if (arg == "--formulation=lazy") {
+                formulation = Formulation::LAZY_SUBTOUR;
+            }
+            else if (arg == "--formulation=symmetric") {
+                formulation = Formulation::SYMMETRIC;
+            }
+            else if (arg == "--formulation=flow") {
+                formulation = Formulation::GAVISH_GRAVES;
+            }
+            else if (arg == "--warm-start") {
+                warm_start = true;
+            }
+            else if (arg == "--cutoff") {
+                warm_start = use_cutoff = true;
+            }
+            else if (arg == "--sparse") {
+                sparse = true;
+            }
+            else if (arg.rfind("--threads-per-solve=", 0) == 0) {
+                threads_per_solve = std::stoul(arg.substr(20));
+            }
+            else if (arg.rfind("--what-if=", 0) == 0) {
+                what_if_runs = std::stoi(arg.substr(10));
+            }
+#endif
+        }
+        const std::string units = cost_model.units();
+
         std::vector<std::tuple<int, int, int>> board_configs = {
             {50, 50, 2},     // Small boards
             {75, 75, 3},     // Medium-small boards
@@ -84,101 +245,167 @@ int main(int argc, char const* argv[]) {
             return 1;
         }
 
-        for (const auto& folder : { "small", "medium", "large" }) {
-            if (!createDirectoryIfNeeded("data/" + std::string(folder))) {
-                std::cerr << "Failed to create " << folder << " directory" << std::endl;
-                return 1;
-            }
+        // Generate every board up front; seeds 1..10 per configuration keep reruns reproducible
+        BatchGenerator generator("data", 0, cost_model);
+        auto manifest = generator.run(board_configs, 1, 10);
+        std::cout << "Generated " << manifest.size() << " instances, manifest: "
+            << generator.manifestPath() << "\n";
+
+        std::vector<BatchResult> results;
+        std::vector<std::string> notes(manifest.size());   // backend remarks per board
+        std::string backend_summary;
+        auto batch_start = std::chrono::high_resolution_clock::now();
+
+        if (exact_backend) {
+            std::cout << "Solving " << manifest.size() << " instances with the in-tree exact solver\n";
+            results = solveWithExactBackend(manifest, total_threads);
+            backend_summary = "in-tree exact solver";
         }
+#ifndef NO_CPLEX
+        else {
+            if (what_if_runs > 0) {
+                runWhatIf(manifest.front(), cost_model, formulation, what_if_runs);
+                return 0;
+            }
+
+            // Build one job per board; model preparation runs on the solver threads
+            std::vector<BatchJob> jobs;
+            std::vector<double> start_costs(manifest.size(), 0.0);
+            for (std::size_t k = 0; k < manifest.size(); k++) {
+                const auto& entry = manifest[k];
+                BatchJob job;
+                job.name = entry.filename;
+                job.costs = TSPGenerator::loadFromFile(entry.filename);
+                job.time_limit = timeLimitFor(job.costs.size());
+
+                job.formulation = formulation;
+                if (formulation == Formulation::SYMMETRIC && !CostMatrix::isSymmetric(job.costs)) {
+                    job.formulation = Formulation::GAVISH_GRAVES;
+                }
 
-        for (const auto& config : board_configs) {
-            int width = std::get<0>(config);
-            int height = std::get<1>(config);
-            int components = std::get<2>(config);
-
-            std::cout << "\n=== Testing circuit board " << width << "x" << height
-                << " with " << components << " components ===\n\n";
-
-            for (int instance = 0; instance < 10; instance++) {
-                auto costs = TSPGenerator::generateCircuitBoard(width, height, components);
-                int N = costs.size();
-                std::string category = getSizeCategory(N);
-
-                auto timestamp = std::chrono::system_clock::now().time_since_epoch().count();
-                std::string filename = "data/" + category + "/board_" +
-                    std::to_string(width) + "x" +
-                    std::to_string(height) + "_" +
-                    std::to_string(timestamp) + "_" +
-                    std::to_string(instance) + ".dat";
-
-                TSPGenerator::saveToFile(filename, costs,
-                    "Circuit board instance\nSize: " + category + "\nNodes: " + std::to_string(N));
-
-                std::cout << "Generated instance: " << filename << " (nodes: " << N << ")\n";
-
-                std::cout << "\nBoard Manufacturing Specifications:\n"
-                    << "- Dimensions: " << width << "x" << height << " mm\n"
-                    << "- Components: " << components << "\n"
-                    << "- Total holes: " << N << "\n"
-                    << "- Min hole spacing: " << TSPGenerator::MIN_HOLE_SPACING << " mm\n"
-                    << "- Edge clearance: " << TSPGenerator::EDGE_MARGIN << " mm\n\n";
-
-                DECL_ENV(env);
-                DECL_PROB(env, lp);
-
-                // Set time limit based on problem size
-                double time_limit = N <= 20 ? 10.0 :     // 10 seconds for small
-                    N <= 35 ? 60.0 :     // 1 minute for medium
-                    300.0;               // 5 minutes for large
-
-                CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_TILIM, time_limit);
-
-                auto model_start = std::chrono::high_resolution_clock::now();
-                TSPModel model;
-                model.createModel(env, lp, N, costs);
-                auto solve_start = std::chrono::high_resolution_clock::now();
-
-                double objval;
-                std::vector<int> tour;
-                bool solved = model.solve(env, lp, objval, tour);
-                auto end = std::chrono::high_resolution_clock::now();
-
-                if (solved) {
-                    double setup_time = std::chrono::duration<double>(solve_start - model_start).count();
-                    double solve_time = std::chrono::duration<double>(end - solve_start).count();
-                    double total_time = setup_time + solve_time;
-
-                    int solstat = CPXgetstat(env, lp);
-                    bool optimal = (solstat == CPXMIP_OPTIMAL);
-
-                    double best_bound;
-                    CPXgetbestobjval(env, lp, &best_bound);
-                    double gap = ((objval - best_bound) / objval) * 100.0;
-
-                    std::cout << "Performance Metrics:\n"
-                        << "- Model setup time: " << setup_time << " seconds\n"
-                        << "- Solution time: " << solve_time << " seconds\n"
-                        << "- Total time: " << total_time << " seconds\n"
-                        << "- Solution status: " << (optimal ? "Optimal" : "Not optimal") << "\n"
-                        << "- Optimality gap: " << std::fixed << std::setprecision(2)
-                        << gap << "%\n\n";
-
-                    std::cout << "Solution Quality:\n"
-                        << "- Total drilling path length: " << objval << " mm\n"
-                        << "- Average distance between holes: " << objval / N << " mm\n\n";
-
-                    std::cout << "Drilling sequence: ";
-                    for (int node : tour) {
-                        std::cout << node << " -> ";
+                double& start_cost = start_costs[k];
+                job.prepare = [&entry, &start_cost, sparse, warm_start, use_cutoff](TSPModel& model,
+                        const BatchJob& job) {
+                    const auto& costs = job.costs;
+                    int N = costs.size();
+                    if (sparse) {
+                        // Same seed, same board: rebuild the hole layout for the geometric neighbourhood
+                        auto holes = TSPGenerator::generateHoles(entry.width, entry.height,
+                            entry.components, entry.seed);
+                        auto arcs = CandidateGraph::empty(N);
+                        CandidateGraph::addNearest(arcs, costs, 5);
+                        if (static_cast<int>(holes.size()) == N) {
+                            CandidateGraph::addDelaunay(arcs, holes);
+                        }
+                        model.setCandidateArcs(arcs);
                     }
-                    std::cout << "0\n\n";
+                    if (warm_start) {
+                        std::vector<int> start = TourHeuristic::initialTour(costs);
+                        start_cost = TourHeuristic::tourCost(costs, start);
+                        model.setInitialTour(start);
+                        // Slightly above the start so CPLEX keeps it as incumbent
+                        if (use_cutoff) model.setCutoff(start_cost + 1e-6 * std::max(1.0, start_cost));
+                    }
+                };
+                jobs.push_back(std::move(job));
+            }
+
+            BatchSolver solver(total_threads, threads_per_solve);
+            std::cout << "Solving " << jobs.size() << " instances on " << solver.getTotalThreads()
+                << " threads\n";
+            results = solver.run(jobs);
+            backend_summary = std::to_string(solver.environments()) + " CPLEX environment(s)";
+
+            for (std::size_t k = 0; k < jobs.size(); k++) {
+                std::ostringstream note;
+                int N = results[k].nodes;
+                if (jobs[k].formulation != formulation) {
+                    note << "Asymmetric costs, used the flow formulation\n\n";
                 }
+                if (warm_start) {
+                    note << "Heuristic start: " << start_costs[k] << " " << units << "\n\n";
+                }
+                if (sparse) {
+                    int all = jobs[k].formulation == Formulation::SYMMETRIC ? N * (N - 1) / 2 : N * (N - 1);
+                    note << "Sparse model: " << results[k].arcs << " of " << all
+                        << " arcs after pricing\n\n";
+                }
+                notes[k] = note.str();
+            }
+        }
+#endif
+        double batch_time = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - batch_start).count();
+
+        int last_width = -1, last_height = -1;
+        for (std::size_t k = 0; k < manifest.size(); k++) {
+            const auto& entry = manifest[k];
+            const auto& result = results[k];
+            int width = entry.width;
+            int height = entry.height;
+            int components = entry.components;
+            int N = result.nodes;
+
+            if (width != last_width || height != last_height) {
+                std::cout << "\n=== Testing circuit board " << width << "x" << height
+                    << " with " << components << " components ===\n\n";
+                last_width = width;
+                last_height = height;
+            }
 
-                CPXfreeprob(env, &lp);
-                CPXcloseCPLEX(&env);
+            std::cout << "Loaded instance: " << entry.filename << " (nodes: " << N
+                << ", seed: " << entry.seed << ")\n";
+
+            std::cout << "\nBoard Manufacturing Specifications:\n"
+                << "- Dimensions: " << width << "x" << height << " mm\n"
+                << "- Components: " << components << "\n"
+                << "- Total holes: " << N << "\n"
+                << "- Min hole spacing: " << TSPGenerator::MIN_HOLE_SPACING << " mm\n"
+                << "- Edge clearance: " << TSPGenerator::EDGE_MARGIN << " mm\n\n";
+
+            if (!result.error.empty()) {
+                std::cout << ">>>EXCEPTION: " << result.error << "\n\n";
+                continue;
             }
+            std::cout << notes[k];
+
+            const SolveResult& solution = result.solution;
+            std::cout << "Performance Metrics:\n"
+                << "- Method: " << result.method << "\n"
+                << "- Threads: " << result.threads << "\n"
+                << "- Model setup time: " << result.setup_time << " seconds\n"
+                << "- Solution time: " << solution.solve_time << " seconds\n"
+                << "- Total time: " << result.setup_time + solution.solve_time << " seconds\n"
+                << "- Solution status: " << (solution.optimal ? "Optimal" : "Not optimal")
+                << " (" << solution.status_text << ")\n"
+                << "- Branch-and-bound nodes: " << solution.nodes << "\n";
+
+            if (!solution.has_solution) {
+                std::cout << "- No solution: " << solution.issue << "\n\n";
+                continue;
+            }
+            std::cout << "- Optimality gap: " << std::fixed << std::setprecision(2)
+                << solution.gap << "%\n\n";
+
+            if (!solution.valid) {
+                std::cout << "Invalid solution: " << solution.issue << "\n\n";
+                continue;
+            }
+
+            std::cout << "Solution Quality (" << cost_model.name() << " cost model):\n"
+                << "- Total drilling path cost: " << solution.objval << " " << units << "\n"
+                << "- Average cost between holes: " << solution.objval / N << " " << units << "\n"
+                << "- Machine cycle time: " << cost_model.cycleTime(solution.objval, N) << " s\n\n";
+
+            std::cout << "Drilling sequence: ";
+            for (int node : solution.tour) {
+                std::cout << node << " -> ";
+            }
+            std::cout << "0\n\n";
         }
 
+        std::cout << "Batch wall time: " << batch_time << " seconds, " << backend_summary << "\n";
+
         return 0;
     }
     catch (std::exception& e) {
@@ -2,12 +2,17 @@
 #include <cpxmacro.h>
 #include <ilcplex/cplex.h>
 #include <model.h>
+#include <subtour_separation.h>
+#include <candidate_graph.h>
+#include <tour_heuristic.h>
+#include <cost_matrix.h>
+#include <algorithm>
+#include <cmath>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 
 // PCB Manufacturing Constants
-const double DRILL_SPEED = 50.0;      // mm/sec average drill movement speed
-const double DRILL_TIME = 0.5;        // seconds per hole
 const double MIN_SPACING = 0.8;       // minimum hole spacing in mm
 const double BOARD_THICKNESS = 1.6;   // standard PCB thickness
 
@@ -15,172 +20,604 @@ void TSPModel::setupVariables(CEnv env, Prob lp, int N, const std::vector<std::v
     int current_var_position = 0;
 
     // Initialize mappings
-    map_x.resize(N, std::vector<int>(N, -1));
-    map_y.resize(N, std::vector<int>(N, -1));
+    map_x.assign(N, std::vector<int>(N, -1));
+    map_y.assign(N, std::vector<int>(N, -1));
+
+    // N(N-1) path variables plus (N-1)^2 flow variables for the flow model
+    // (an upper bound in sparse mode)
+    const bool with_flow = formulation == Formulation::GAVISH_GRAVES;
+    const std::size_t expected_cols = static_cast<std::size_t>(N) * (N - 1) +
+        (with_flow ? static_cast<std::size_t>(N - 1) * (N - 1) : 0);
+    std::vector<double> obj, lb, ub;
+    std::vector<char> ctype;
+    std::vector<std::string> names;
+    obj.reserve(expected_cols);
+    lb.reserve(expected_cols);
+    ub.reserve(expected_cols);
+    ctype.reserve(expected_cols);
+    if (use_names) names.reserve(expected_cols);
 
     // Create flow variables x[i][j] - only for j≠0
-    for (int i = 0; i < N; i++) {
+    for (int i = 0; i < N && with_flow; i++) {
         for (int j = 1; j < N; j++) {
-            if (i != j) {
-                char xtype = 'C';
-                double lb = 0.0;
-                double ub = CPX_INFBOUND;
-                char* name = new char[50];  // Allocate memory for the name
-                snprintf(name, 50, "x_%d_%d", i, j);  // Create the name string
-                double obj = 0.0;  // Flow variables not in objective
-
-                // Make the CPLEX call with properly typed parameters
-                CHECKED_CPX_CALL(CPXnewcols, env, lp, 1, &obj, &lb, &ub, &xtype, &name);
-                delete[] name;  // Clean up allocated memory
-
+            if (isArc(i, j)) {
+                obj.push_back(0.0);  // Flow variables not in objective
+                lb.push_back(0.0);
+                ub.push_back(CPX_INFBOUND);
+                ctype.push_back('C');
+                if (use_names) names.push_back("x_" + std::to_string(i) + "_" + std::to_string(j));
                 map_x[i][j] = current_var_position++;
             }
         }
     }
 
-    // Create path variables y[i][j]
+    // Create path variables y[i][j]; the symmetric model has one edge
+    // variable z_ij (i < j), mapped from both directions
+    first_arc = current_var_position;
+    arc_tail.clear();
+    arc_head.clear();
+    const bool symmetric = formulation == Formulation::SYMMETRIC;
     for (int i = 0; i < N; i++) {
-        for (int j = 0; j < N; j++) {
-            if (i != j) {
-                char ytype = 'B';
-                double lb = 0.0;
-                double ub = 1.0;
-                char* name = new char[50];
-                snprintf(name, 50, "y_%d_%d", i, j);
-                double obj = costs[i][j];
-
-                CHECKED_CPX_CALL(CPXnewcols, env, lp, 1, &obj, &lb, &ub, &ytype, &name);
-                delete[] name;
-
+        for (int j = symmetric ? i + 1 : 0; j < N; j++) {
+            if (isArc(i, j)) {
+                obj.push_back(costs[i][j]);
+                lb.push_back(0.0);
+                ub.push_back(1.0);
+                ctype.push_back('B');
+                if (use_names) names.push_back((symmetric ? "z_" : "y_") + std::to_string(i) +
+                    "_" + std::to_string(j));
+                if (symmetric) map_y[j][i] = current_var_position;
                 map_y[i][j] = current_var_position++;
+                arc_tail.push_back(i);
+                arc_head.push_back(j);
             }
         }
     }
+
+    std::vector<char*> colname;
+    if (use_names) {
+        colname.reserve(names.size());
+        for (auto& name : names) colname.push_back(&name[0]);
+    }
+
+    CHECKED_CPX_CALL(CPXnewcols, env, lp, current_var_position, obj.data(), lb.data(),
+        ub.data(), ctype.data(), use_names ? colname.data() : NULL);
+    num_cols = current_var_position;
+    num_arcs = current_var_position - first_arc;
 }
 
-void TSPModel::setupFlowConservation(CEnv env, Prob lp, int N) {
+void TSPModel::setupFlowConservation(RowBuffer& rows, int N) {
     for (int k = 1; k < N; k++) {
-        std::vector<int> idx;
-        std::vector<double> coef;
+        rows.beginRow('E', 1.0);
 
         // Incoming flows
         for (int i = 0; i < N; i++) {
             if (i != k && map_x[i][k] >= 0) {
-                idx.push_back(map_x[i][k]);
-                coef.push_back(1.0);
+                rows.add(map_x[i][k], 1.0);
             }
         }
 
         // Outgoing flows (j≠0)
         for (int j = 1; j < N; j++) {
             if (j != k && map_x[k][j] >= 0) {
-                idx.push_back(map_x[k][j]);
-                coef.push_back(-1.0);
+                rows.add(map_x[k][j], -1.0);
             }
         }
-
-        char sense = 'E';
-        double rhs = 1.0;
-        int matbeg = 0;
-        CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, &idx[0], &coef[0], NULL, NULL);
     }
 }
 
-void TSPModel::setupAssignmentConstraints(CEnv env, Prob lp, int N) {
+void TSPModel::setupAssignmentConstraints(RowBuffer& rows, int N) {
     // One outgoing arc
     for (int i = 0; i < N; i++) {
-        std::vector<int> idx;
-        std::vector<double> coef;
+        rows.beginRow('E', 1.0);
         for (int j = 0; j < N; j++) {
             if (i != j && map_y[i][j] >= 0) {
-                idx.push_back(map_y[i][j]);
-                coef.push_back(1.0);
+                rows.add(map_y[i][j], 1.0);
             }
         }
-        char sense = 'E';
-        double rhs = 1.0;
-        int matbeg = 0;
-        CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, &idx[0], &coef[0], NULL, NULL);
     }
 
     // One incoming arc
     for (int j = 0; j < N; j++) {
-        std::vector<int> idx;
-        std::vector<double> coef;
+        rows.beginRow('E', 1.0);
         for (int i = 0; i < N; i++) {
             if (i != j && map_y[i][j] >= 0) {
-                idx.push_back(map_y[i][j]);
-                coef.push_back(1.0);
+                rows.add(map_y[i][j], 1.0);
             }
         }
-        char sense = 'E';
-        double rhs = 1.0;
-        int matbeg = 0;
-        CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense, &matbeg, &idx[0], &coef[0], NULL, NULL);
     }
 }
 
-void TSPModel::setupLinkingConstraints(CEnv env, Prob lp, int N) {
+void TSPModel::setupDegreeConstraints(RowBuffer& rows, int N) {
+    // Two incident edges per node
+    for (int i = 0; i < N; i++) {
+        rows.beginRow('E', 2.0);
+        for (int j = 0; j < N; j++) {
+            if (i != j && map_y[i][j] >= 0) {
+                rows.add(map_y[i][j], 1.0);
+            }
+        }
+    }
+}
+
+void TSPModel::setupLinkingConstraints(RowBuffer& rows, int N) {
+    const double bigN = static_cast<double>(N);
     for (int i = 0; i < N; i++) {
         for (int j = 1; j < N; j++) {
             if (i != j && map_x[i][j] >= 0 && map_y[i][j] >= 0) {
-                // Create index vector for the two variables involved
-                std::vector<int> idx = { map_x[i][j], map_y[i][j] };
-
-                // Fix: Cast N to double before arithmetic to avoid conversion error
-                double bigN = static_cast<double>(N);
-                std::vector<double> coef = { 1.0, -(bigN - 1.0) };
-
-                char sense = 'L';
-                double rhs = 0.0;
-                int matbeg = 0;
-
-                CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, 1, idx.size(), &rhs, &sense,
-                    &matbeg, &idx[0], &coef[0], NULL, NULL);
+                // x_ij - (N-1) y_ij <= 0
+                rows.beginRow('L', 0.0);
+                rows.add(map_x[i][j], 1.0);
+                rows.add(map_y[i][j], -(bigN - 1.0));
             }
         }
     }
 }
 
 void TSPModel::setupConstraints(CEnv env, Prob lp, int N) {
-    setupFlowConservation(env, lp, N);
-    setupAssignmentConstraints(env, lp, N);
-    setupLinkingConstraints(env, lp, N);
+    // (N-1) flow rows, 2N assignment rows, (N-1)^2 linking rows; the lazy
+    // formulation keeps only the assignment rows, the symmetric one N degree rows
+    const std::size_t n = static_cast<std::size_t>(N);
+    const std::size_t flow = formulation == Formulation::GAVISH_GRAVES ? 1 : 0;
+    RowBuffer rows;
+    rows.reserve(flow * ((n - 1) + (n - 1) * (n - 1)) + 2 * n,
+        flow * ((n - 1) * 2 * (n - 1) + 2 * (n - 1) * (n - 1)) + 2 * n * (n - 1));
+
+    if (formulation == Formulation::GAVISH_GRAVES) {
+        setupFlowConservation(rows, N);
+    }
+    if (formulation == Formulation::SYMMETRIC) {
+        setupDegreeConstraints(rows, N);
+    }
+    else {
+        setupAssignmentConstraints(rows, N);
+    }
+    if (formulation == Formulation::GAVISH_GRAVES) {
+        setupLinkingConstraints(rows, N);
+    }
+
+    CHECKED_CPX_CALL(CPXaddrows, env, lp, 0, static_cast<int>(rows.rhs.size()),
+        static_cast<int>(rows.rmatind.size()), rows.rhs.data(), rows.sense.data(),
+        rows.rmatbeg.data(), rows.rmatind.data(), rows.rmatval.data(), NULL, NULL);
 }
 
-void TSPModel::createModel(CEnv env, Prob lp, int N, const std::vector<std::vector<double>>& costs) {
+void TSPModel::createModel(Env env, Prob lp, int N, const std::vector<std::vector<double>>& costs) {
+    if (formulation == Formulation::SYMMETRIC && !CostMatrix::isSymmetric(costs)) {
+        throw std::invalid_argument("Symmetric formulation requires a symmetric cost matrix");
+    }
+    arc_costs = costs;
+
+    if (!candidate.empty()) {
+        // The sparse model must contain at least one tour
+        if (initial_tour.empty()) {
+            setInitialTour(TourHeuristic::initialTour(costs));
+        }
+        CandidateGraph::addTour(candidate, initial_tour);
+
+        do {
+            solvePricingLP(env, N);
+        } while (addArcsBelow(-PRICING_EPS) > 0);
+    }
+
     setupVariables(env, lp, N, costs);
     setupConstraints(env, lp, N);
+
+    if (formulation != Formulation::GAVISH_GRAVES) {
+        CHECKED_CPX_CALL(CPXcallbacksetfunc, env, lp,
+            CPX_CALLBACKCONTEXT_CANDIDATE | CPX_CALLBACKCONTEXT_RELAXATION,
+            &TSPModel::subtourCallback, this);
+    }
 }
 
-bool TSPModel::solve(CEnv env, Prob lp, double& objval, std::vector<int>& tour) {
-    CHECKED_CPX_CALL(CPXmipopt, env, lp);
+void TSPModel::solvePricingLP(Env env, int N) {
+    // Scratch LP with the current arc set; the caller's problem is untouched
+    DECL_PROB(env, pricing);
+    try {
+        setupVariables(env, pricing, N, arc_costs);
+        setupConstraints(env, pricing, N);
+        CHECKED_CPX_CALL(CPXchgprobtype, env, pricing, CPXPROB_LP);
+        CHECKED_CPX_CALL(CPXlpopt, env, pricing);
+        if (CPXgetstat(env, pricing) != CPX_STAT_OPTIMAL) {
+            throw std::runtime_error("Pricing LP not solved to optimality");
+        }
+        CHECKED_CPX_CALL(CPXgetobjval, env, pricing, &lp_bound);
 
-    // Get objective value
-    CHECKED_CPX_CALL(CPXgetobjval, env, lp, &objval);
+        // Row order follows setupConstraints: flow, out-degree, in-degree
+        // (a single degree row per node in the symmetric model)
+        const int flow_rows = formulation == Formulation::GAVISH_GRAVES ? N - 1 : 0;
+        const int degree_rows = formulation == Formulation::SYMMETRIC ? N : 2 * N;
+        std::vector<double> pi(flow_rows + degree_rows);
+        CHECKED_CPX_CALL(CPXgetpi, env, pricing, pi.data(), 0, flow_rows + degree_rows - 1);
 
-    // Get solution values
-    int n = CPXgetnumcols(env, lp);
-    std::vector<double> x(n);
-    CHECKED_CPX_CALL(CPXgetx, env, lp, &x[0], 0, n - 1);
+        dual_flow.assign(N, 0.0);
+        for (int k = 1; k <= flow_rows; k++) dual_flow[k] = pi[k - 1];
+        dual_out.assign(pi.begin() + flow_rows, pi.begin() + flow_rows + N);
+        if (formulation == Formulation::SYMMETRIC) {
+            dual_in = dual_out;  // rc_ij = c_ij - pi_i - pi_j
+        }
+        else {
+            dual_in.assign(pi.begin() + flow_rows + N, pi.end());
+        }
+    }
+    catch (...) {
+        CPXfreeprob(env, &pricing);
+        throw;
+    }
+    CPXfreeprob(env, &pricing);
+}
 
-    // Extract tour
-    tour.clear();
-    tour.push_back(0);  // Start at depot
-    int current = 0;
-    int N = map_y.size();
+double TSPModel::reducedCost(int i, int j) const {
+    const int N = map_y.size();
+    double rc = arc_costs[i][j] - dual_out[i] - dual_in[j];
+    // Best choice of the linking row dual gamma_ij <= 0 for the pair x_ij, y_ij
+    if (j != 0 && formulation == Formulation::GAVISH_GRAVES) {
+        rc += (N - 1) * std::min(0.0, dual_flow[i] - dual_flow[j]);
+    }
+    return rc;
+}
 
-    for (int i = 0; i < N - 1; i++) {
+int TSPModel::addArcsBelow(double threshold) {
+    const int N = map_y.size();
+    int added = 0;
+    for (int i = 0; i < N; i++) {
         for (int j = 0; j < N; j++) {
-            if (current != j && map_y[current][j] >= 0 && x[map_y[current][j]] > 0.5) {
-                tour.push_back(j);
-                current = j;
-                break;
+            if (i != j && !candidate[i][j] && reducedCost(i, j) < threshold) {
+                candidate[i][j] = 1;
+                if (formulation == Formulation::SYMMETRIC) candidate[j][i] = 1;
+                added++;
+            }
+        }
+    }
+    return added;
+}
+
+void TSPModel::rebuildModel(Env env, Prob lp, int N) {
+    int starts = CPXgetnummipstarts(env, lp);
+    if (starts > 0) {
+        CHECKED_CPX_CALL(CPXdelmipstarts, env, lp, 0, starts - 1);
+    }
+    int rows = CPXgetnumrows(env, lp);
+    if (rows > 0) {
+        CHECKED_CPX_CALL(CPXdelrows, env, lp, 0, rows - 1);
+    }
+    int cols = CPXgetnumcols(env, lp);
+    if (cols > 0) {
+        CHECKED_CPX_CALL(CPXdelcols, env, lp, 0, cols - 1);
+    }
+
+    // The generic callback stays registered on lp
+    setupVariables(env, lp, N, arc_costs);
+    setupConstraints(env, lp, N);
+}
+
+void TSPModel::updateCosts(Env env, Prob lp, const std::vector<std::vector<double>>& costs) {
+    const int N = map_y.size();
+    if (static_cast<int>(costs.size()) != N) {
+        throw std::invalid_argument("updateCosts needs a " + std::to_string(N) + "-node matrix");
+    }
+    if (!candidate.empty()) {
+        throw std::logic_error("updateCosts is not available for sparse models");
+    }
+    if (formulation == Formulation::SYMMETRIC && !CostMatrix::isSymmetric(costs)) {
+        throw std::invalid_argument("Symmetric formulation requires a symmetric cost matrix");
+    }
+    arc_costs = costs;
+
+    std::vector<int> indices(num_arcs);
+    std::vector<double> values(num_arcs);
+    for (int a = 0; a < num_arcs; a++) {
+        indices[a] = first_arc + a;
+        values[a] = costs[arc_tail[a]][arc_head[a]];
+    }
+    CHECKED_CPX_CALL(CPXchgobj, env, lp, num_arcs, indices.data(), values.data());
+
+    // solve() would re-add initial_tour as a MIP start; the caller decides
+    // whether the last tour seeds the next solve (setInitialTour)
+    initial_tour.clear();
+    int starts = CPXgetnummipstarts(env, lp);
+    if (starts > 0) {
+        CHECKED_CPX_CALL(CPXdelmipstarts, env, lp, 0, starts - 1);
+    }
+    if (use_cutoff) {
+        clearCutoff();
+        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_CUTUP, 1e75);  // CPLEX default
+    }
+}
+
+int CPXPUBLIC TSPModel::subtourCallback(CPXCALLBACKCONTEXTptr context, CPXLONG contextid,
+    void* userhandle) {
+    const TSPModel* model = static_cast<const TSPModel*>(userhandle);
+
+    // Exceptions must not cross the CPLEX C boundary
+    try {
+        if (contextid == CPX_CALLBACKCONTEXT_CANDIDATE) {
+            return model->separateCandidate(context);
+        }
+        if (contextid == CPX_CALLBACKCONTEXT_RELAXATION) {
+            return model->separateRelaxation(context);
+        }
+    }
+    catch (std::exception& e) {
+        std::cerr << "Subtour callback failed: " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+std::vector<std::vector<double>> TSPModel::undirectedSupport(const std::vector<double>& y) const {
+    const int N = map_y.size();
+    std::vector<std::vector<double>> w(N, std::vector<double>(N, 0.0));
+    for (int i = 0; i < N; i++) {
+        for (int j = i + 1; j < N; j++) {
+            double both = 0.0;
+            if (map_y[i][j] >= 0) both += y[map_y[i][j]];
+            // Symmetric model: both directions map to the same edge column
+            if (map_y[j][i] >= 0 && formulation != Formulation::SYMMETRIC) both += y[map_y[j][i]];
+            w[i][j] = w[j][i] = both;
+        }
+    }
+    return w;
+}
+
+void TSPModel::addSubtourCut(const std::vector<int>& subset, RowBuffer& cuts) const {
+    const int N = map_y.size();
+    const int size = subset.size();
+    std::vector<char> inside(N, 0);
+    for (int v : subset) inside[v] = 1;
+
+    // Same SEC in whichever form has fewer nonzeros:
+    // sum_{i,j in S} y_ij <= |S|-1  (|S|(|S|-1) terms)  or
+    // sum_{i in S, j notin S} y_ij >= 1  (|S|(N-|S|) terms)
+    // With edge variables the inner sum takes i < j and the cut needs >= 2
+    const bool symmetric = formulation == Formulation::SYMMETRIC;
+    if (size - 1 <= N - size) {
+        cuts.beginRow('L', size - 1.0);
+        for (int i : subset) {
+            for (int j : subset) {
+                if ((symmetric ? i < j : i != j) && map_y[i][j] >= 0) cuts.add(map_y[i][j], 1.0);
+            }
+        }
+    }
+    else {
+        cuts.beginRow('G', symmetric ? 2.0 : 1.0);
+        for (int i : subset) {
+            for (int j = 0; j < N; j++) {
+                if (!inside[j] && map_y[i][j] >= 0) cuts.add(map_y[i][j], 1.0);
             }
         }
     }
+}
+
+int TSPModel::separateCandidate(CPXCALLBACKCONTEXTptr context) const {
+    int ispoint = 0;
+    int rc = CPXcallbackcandidateispoint(context, &ispoint);
+    if (rc || !ispoint) return rc;
+
+    std::vector<double> y(num_cols);
+    double objval;
+    rc = CPXcallbackgetcandidatepoint(context, y.data(), 0, num_cols - 1, &objval);
+    if (rc) return rc;
+
+    // Integer point: every component of the selected arcs is a cycle
+    auto components = SubtourSeparation::connectedComponents(undirectedSupport(y), 0.5);
+    if (components.size() <= 1) return 0;
+
+    RowBuffer cuts;
+    for (const auto& subset : components) {
+        addSubtourCut(subset, cuts);
+    }
+    return CPXcallbackrejectcandidate(context, static_cast<int>(cuts.rhs.size()),
+        static_cast<int>(cuts.rmatind.size()), cuts.rhs.data(), cuts.sense.data(),
+        cuts.rmatbeg.data(), cuts.rmatind.data(), cuts.rmatval.data());
+}
+
+int TSPModel::separateRelaxation(CPXCALLBACKCONTEXTptr context) const {
+    std::vector<double> y(num_cols);
+    double objval;
+    int rc = CPXcallbackgetrelaxationpoint(context, y.data(), 0, num_cols - 1, &objval);
+    if (rc) return rc;
+
+    auto w = undirectedSupport(y);
+    RowBuffer cuts;
+
+    // Disconnected support: one cut per component, no min-cut needed
+    auto components = SubtourSeparation::connectedComponents(w);
+    if (components.size() > 1) {
+        for (const auto& subset : components) {
+            addSubtourCut(subset, cuts);
+        }
+    }
+    else {
+        // In a tour every cut carries y(delta+(S)) + y(delta-(S)) >= 2
+        std::vector<int> shore;
+        double cut = SubtourSeparation::minimumCut(w, shore);
+        if (cut < 2.0 - 2.0 * CUT_VIOLATION) {
+            addSubtourCut(shore, cuts);
+        }
+    }
+
+    if (cuts.rhs.empty()) return 0;
+
+    const int rcnt = cuts.rhs.size();
+    std::vector<int> purgeable(rcnt, CPX_USECUT_FILTER);
+    std::vector<int> local(rcnt, 0);
+    return CPXcallbackaddusercuts(context, rcnt, static_cast<int>(cuts.rmatind.size()),
+        cuts.rhs.data(), cuts.sense.data(), cuts.rmatbeg.data(), cuts.rmatind.data(),
+        cuts.rmatval.data(), purgeable.data(), local.data());
+}
+
+void TSPModel::setInitialTour(const std::vector<int>& tour) {
+    const int N = tour.size();
+    std::vector<char> seen(N, 0);
+    int depot = -1;
+    for (int p = 0; p < N; p++) {
+        if (tour[p] < 0 || tour[p] >= N || seen[tour[p]]) {
+            throw std::invalid_argument("Initial tour is not a permutation of the nodes");
+        }
+        seen[tour[p]] = 1;
+        if (tour[p] == 0) depot = p;
+    }
+
+    // Rotate so the tour starts at the depot, as the flow model expects
+    initial_tour.assign(tour.begin() + depot, tour.end());
+    initial_tour.insert(initial_tour.end(), tour.begin(), tour.begin() + depot);
+}
+
+void TSPModel::addMipStart(CEnv env, Prob lp) const {
+    const int N = map_y.size();
+    if (static_cast<int>(initial_tour.size()) != N) {
+        throw std::invalid_argument("Initial tour has " + std::to_string(initial_tour.size()) +
+            " nodes, model has " + std::to_string(N));
+    }
+
+    // Complete start: every column gets a value, zero unless on the tour
+    std::vector<double> values(num_cols, 0.0);
+    for (int p = 0; p < N; p++) {
+        int i = initial_tour[p];
+        int j = initial_tour[(p + 1) % N];
+        if (map_y[i][j] < 0) {
+            throw std::invalid_argument("Initial tour uses an arc missing from the sparse model");
+        }
+        values[map_y[i][j]] = 1.0;
+        // One unit of flow is delivered at each node after the depot
+        if (j != 0 && map_x[i][j] >= 0) {
+            values[map_x[i][j]] = N - 1 - p;
+        }
+    }
+
+    std::vector<int> indices(num_cols);
+    for (int c = 0; c < num_cols; c++) indices[c] = c;
+    const int beg = 0;
+    const int effort = CPX_MIPSTART_CHECKFEAS;
+
+    CHECKED_CPX_CALL(CPXaddmipstarts, env, lp, 1, num_cols, &beg, indices.data(),
+        values.data(), &effort, NULL);
+}
+
+std::vector<int> TSPModel::extractTour(const std::vector<double>& y, std::string& issue) const {
+    const int N = map_y.size();
+    const bool symmetric = formulation == Formulation::SYMMETRIC;
+
+    // Successor array from one pass over the arc values; an edge variable
+    // gives both endpoints a neighbour, the walk takes the one not just left
+    std::vector<int> next(N, -1), other(N, -1);
+    auto attach = [&](int u, int v) {
+        if (next[u] < 0) next[u] = v;
+        else if (symmetric && other[u] < 0) other[u] = v;
+        else issue = "node " + std::to_string(u) + " has too many selected arcs";
+    };
+    for (int a = 0; a < num_arcs && issue.empty(); a++) {
+        if (y[a] > 0.5) {
+            attach(arc_tail[a], arc_head[a]);
+            if (symmetric) attach(arc_head[a], arc_tail[a]);
+        }
+    }
+
+    std::vector<int> tour;
+    tour.reserve(N);
+    tour.push_back(0);  // Start at depot
+    std::vector<char> visited(N, 0);
+    visited[0] = 1;
+    int current = 0, previous = -1;
+
+    while (issue.empty() && static_cast<int>(tour.size()) < N) {
+        int succ = next[current];
+        if (symmetric && succ == previous) succ = other[current];
+        if (succ < 0) {
+            issue = "node " + std::to_string(current) + " has no successor";
+        }
+        else if (visited[succ]) {
+            issue = "subtour of " + std::to_string(tour.size()) + " nodes";
+        }
+        else {
+            visited[succ] = 1;
+            tour.push_back(succ);
+            previous = current;
+            current = succ;
+        }
+    }
+
+    // The last node must close the cycle
+    if (issue.empty() && next[current] != 0 && other[current] != 0) {
+        issue = "tour does not return to the depot";
+    }
+    return tour;
+}
+
+void TSPModel::collectResult(CEnv env, CProb lp, SolveResult& result) const {
+    char buffer[CPXMESSAGEBUFSIZE];
+    result.status = CPXgetstat(env, lp);
+    result.status_text = CPXgetstatstring(env, result.status, buffer) ? buffer : "unknown";
+    result.optimal = result.status == CPXMIP_OPTIMAL || result.status == CPXMIP_OPTIMAL_TOL;
+    result.nodes = CPXgetnodecnt(env, lp);
+
+    int method, type, primal_feasible, dual_feasible;
+    CHECKED_CPX_CALL(CPXsolninfo, env, lp, &method, &type, &primal_feasible, &dual_feasible);
+    result.has_solution = type != CPX_NO_SOLN && primal_feasible;
+    result.tour.clear();
+    result.valid = false;
+    if (!result.has_solution) {
+        result.issue = "no integer solution (" + result.status_text + ")";
+        return;
+    }
+
+    CHECKED_CPX_CALL(CPXgetobjval, env, lp, &result.objval);
+    CHECKED_CPX_CALL(CPXgetbestobjval, env, lp, &result.best_bound);
+    CHECKED_CPX_CALL(CPXgetmiprelgap, env, lp, &result.gap);
+    result.gap *= 100.0;
+
+    // Only the arc columns are needed
+    std::vector<double> y(num_arcs);
+    CHECKED_CPX_CALL(CPXgetx, env, lp, y.data(), first_arc, first_arc + num_arcs - 1);
+
+    result.issue.clear();
+    result.tour = extractTour(y, result.issue);
+    if (!result.issue.empty()) return;
+
+    const int N = result.tour.size();
+    result.tour_cost = 0.0;
+    for (int p = 0; p < N; p++) {
+        result.tour_cost += arc_costs[result.tour[p]][result.tour[(p + 1) % N]];
+    }
+    if (std::abs(result.tour_cost - result.objval) > 1e-6 * std::max(1.0, std::abs(result.objval))) {
+        result.issue = "tour cost " + std::to_string(result.tour_cost) +
+            " differs from objective " + std::to_string(result.objval);
+        return;
+    }
+    result.valid = true;
+}
+
+SolveResult TSPModel::solve(Env env, Prob lp) {
+    SolveResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    if (!initial_tour.empty()) {
+        addMipStart(env, lp);
+    }
+    if (use_cutoff) {
+        CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_CUTUP, cutoff);
+    }
+
+    CHECKED_CPX_CALL(CPXmipopt, env, lp);
+    collectResult(env, lp, result);
+
+    // Sparse model: a tour cheaper than objval can only use arcs with
+    // rc < objval - lp_bound. Add them and solve again from this tour
+    if (!candidate.empty() && result.optimal && result.valid) {
+        if (addArcsBelow(result.objval - lp_bound + PRICING_EPS) > 0) {
+            const int N = map_y.size();
+            long first_nodes = result.nodes;
+            rebuildModel(env, lp, N);
+            setInitialTour(result.tour);
+            addMipStart(env, lp);
+            CHECKED_CPX_CALL(CPXmipopt, env, lp);
+            collectResult(env, lp, result);
+            result.nodes += first_nodes;
+        }
+    }
 
-    return true;
+    result.solve_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
 }
 
 void TSPModel::printSolution(const std::vector<double>& solution, int N) {
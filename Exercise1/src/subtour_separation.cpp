@@ -0,0 +1,98 @@
+// subtour_separation.cpp
+#include <subtour_separation.h>
+#include <limits>
+#include <algorithm>
+
+namespace SubtourSeparation {
+
+    std::vector<std::vector<int>> connectedComponents(
+        const std::vector<std::vector<double>>& w, double eps) {
+
+        const int N = static_cast<int>(w.size());
+        std::vector<int> component(N, -1);
+        std::vector<std::vector<int>> components;
+        std::vector<int> stack;
+
+        for (int start = 0; start < N; start++) {
+            if (component[start] >= 0) continue;
+
+            int id = static_cast<int>(components.size());
+            components.emplace_back();
+            component[start] = id;
+            stack.push_back(start);
+
+            while (!stack.empty()) {
+                int u = stack.back();
+                stack.pop_back();
+                components[id].push_back(u);
+                for (int v = 0; v < N; v++) {
+                    if (component[v] < 0 && w[u][v] > eps) {
+                        component[v] = id;
+                        stack.push_back(v);
+                    }
+                }
+            }
+        }
+
+        return components;
+    }
+
+    double minimumCut(const std::vector<std::vector<double>>& w, std::vector<int>& shore) {
+        const int N = static_cast<int>(w.size());
+        shore.clear();
+        if (N < 2) return std::numeric_limits<double>::infinity();
+
+        // Stoer-Wagner with vertex merging; members[v] lists the original
+        // vertices contracted into v
+        std::vector<std::vector<double>> g = w;
+        std::vector<std::vector<int>> members(N);
+        for (int v = 0; v < N; v++) members[v] = { v };
+
+        std::vector<int> active(N);
+        for (int v = 0; v < N; v++) active[v] = v;
+
+        double best = std::numeric_limits<double>::infinity();
+        std::vector<double> key(N);
+        std::vector<char> added(N);
+
+        while (active.size() > 1) {
+            // Maximum adjacency ordering over the active vertices
+            std::fill(added.begin(), added.end(), 0);
+            for (int v : active) key[v] = 0.0;
+
+            int prev = -1, last = -1;
+            for (std::size_t step = 0; step < active.size(); step++) {
+                int sel = -1;
+                for (int v : active) {
+                    if (!added[v] && (sel < 0 || key[v] > key[sel])) sel = v;
+                }
+                if (sel < 0) break;
+                added[sel] = 1;
+                prev = last;
+                last = sel;
+                for (int v : active) {
+                    if (!added[v]) key[v] += g[sel][v];
+                }
+            }
+
+            // Cut of the phase separates `last` from the rest
+            if (key[last] < best) {
+                best = key[last];
+                shore = members[last];
+            }
+
+            // Merge last into prev
+            for (int v : active) {
+                g[prev][v] += g[last][v];
+                g[v][prev] = g[prev][v];
+            }
+            g[prev][prev] = 0.0;
+            members[prev].insert(members[prev].end(), members[last].begin(), members[last].end());
+            active.erase(std::find(active.begin(), active.end(), last));
+        }
+
+        std::sort(shore.begin(), shore.end());
+        return best;
+    }
+
+}
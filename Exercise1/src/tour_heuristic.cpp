@@ -0,0 +1,79 @@
+// tour_heuristic.cpp
+#include <tour_heuristic.h>
+#include <cost_matrix.h>
+#include <algorithm>
+
+namespace TourHeuristic {
+
+    std::vector<int> nearestNeighbour(const std::vector<std::vector<double>>& costs) {
+        const int N = static_cast<int>(costs.size());
+        std::vector<int> tour;
+        if (N == 0) return tour;
+
+        std::vector<char> visited(N, 0);
+        tour.reserve(N);
+        tour.push_back(0);
+        visited[0] = 1;
+
+        int current = 0;
+        for (int step = 1; step < N; step++) {
+            int next = -1;
+            for (int j = 0; j < N; j++) {
+                if (!visited[j] && (next < 0 || costs[current][j] < costs[current][next])) {
+                    next = j;
+                }
+            }
+            visited[next] = 1;
+            tour.push_back(next);
+            current = next;
+        }
+        return tour;
+    }
+
+    double tourCost(const std::vector<std::vector<double>>& costs, const std::vector<int>& tour) {
+        double total = 0.0;
+        for (std::size_t p = 0; p < tour.size(); p++) {
+            total += costs[tour[p]][tour[(p + 1) % tour.size()]];
+        }
+        return total;
+    }
+
+    double twoOpt(const std::vector<std::vector<double>>& costs, std::vector<int>& tour) {
+        const int N = static_cast<int>(tour.size());
+        if (N < 4) return tourCost(costs, tour);
+
+        const bool symmetric = CostMatrix::isSymmetric(costs);
+        bool improved = true;
+        while (improved) {
+            improved = false;
+            // Reverse tour[i+1..j]: edges (a,b) and (c,d) become (a,c) and (b,d)
+            for (int i = 0; i < N - 2 && !improved; i++) {
+                for (int j = i + 2; j < N && !improved; j++) {
+                    int a = tour[i], b = tour[i + 1];
+                    int c = tour[j], d = tour[(j + 1) % N];
+                    if (a == d) continue;
+
+                    double delta = costs[a][c] + costs[b][d] - costs[a][b] - costs[c][d];
+                    if (!symmetric) {
+                        for (int k = i + 1; k < j; k++) {
+                            delta += costs[tour[k + 1]][tour[k]] - costs[tour[k]][tour[k + 1]];
+                        }
+                    }
+
+                    if (delta < -1e-9) {
+                        std::reverse(tour.begin() + i + 1, tour.begin() + j + 1);
+                        improved = true;
+                    }
+                }
+            }
+        }
+        return tourCost(costs, tour);
+    }
+
+    std::vector<int> initialTour(const std::vector<std::vector<double>>& costs) {
+        std::vector<int> tour = nearestNeighbour(costs);
+        twoOpt(costs, tour);
+        return tour;
+    }
+
+}
@@ -0,0 +1,59 @@
+// tsp_session.cpp
+#include <tsp_session.h>
+
+TSPSession::TSPSession(Formulation formulation)
+    : env(nullptr), lp(nullptr), formulation(formulation), reuse_tour(true),
+      rebuilds(0), updates(0) {
+    DECL_ENV(opened);
+    env = opened;
+}
+
+TSPSession::~TSPSession() {
+    if (lp) CPXfreeprob(env, &lp);
+    CPXcloseCPLEX(&env);
+}
+
+void TSPSession::setTimeLimit(double seconds) {
+    CHECKED_CPX_CALL(CPXsetdblparam, env, CPX_PARAM_TILIM, seconds);
+}
+
+void TSPSession::setThreads(int threads) {
+    CHECKED_CPX_CALL(CPXsetintparam, env, CPX_PARAM_THREADS, threads);
+}
+
+void TSPSession::rebuild(const std::vector<std::vector<double>>& costs) {
+    if (lp) CPXfreeprob(env, &lp);
+    model.reset();
+    last_tour.clear();
+
+    DECL_PROB(env, created);
+    lp = created;
+    model.reset(new TSPModel(formulation));
+    try {
+        model->createModel(env, lp, static_cast<int>(costs.size()), costs);
+    }
+    catch (...) {
+        model.reset();  // half-built problem, rebuild on the next call
+        throw;
+    }
+    rebuilds++;
+}
+
+SolveResult TSPSession::solve(const std::vector<std::vector<double>>& costs) {
+    if (!model || model->getFormulation() != formulation ||
+            model->getNodeCount() != static_cast<int>(costs.size())) {
+        rebuild(costs);
+    }
+    else {
+        model->updateCosts(env, lp, costs);
+        updates++;
+        // Same constraints, so the last tour is still a feasible start
+        if (reuse_tour && !last_tour.empty()) {
+            model->setInitialTour(last_tour);
+        }
+    }
+
+    SolveResult result = model->solve(env, lp);
+    if (result.valid) last_tour = result.tour;
+    return result;
+}
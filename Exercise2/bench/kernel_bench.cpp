@@ -0,0 +1,355 @@
+/**
+* @file kernel_bench.cpp
+* @brief Microbenchmarks of the tabu search kernels in isolation
+*
+* Each kernel runs on random boards of n holes (default 50 ... 10000) with
+* double and int32 costs where the solver supports both. With --panel the
+* boards are PanelGenerator panels (BGA, via fields, connectors stepped over
+* a panel) instead of uniformly scattered holes:
+*   move_cost       TSPSolver::calculateMoveCost, one random 2-opt move
+*   best_neighbor   TSPSolver::findBestNeighbor, full 2-opt scan with a
+*                   full tabu list; unit = one candidate move
+*   is_tabu         TSPSolver::isTabu on a full list (a miss scans it all);
+*                   unit = one list entry
+*   apply_move      TSPSolver::applyMove, random segment; unit = one element
+*   evaluate        TSPSolver::evaluate; unit = one tour edge
+*   distances       TSPGenerator::computeDistances / computeIntegerDistances
+*                   on one thread (the distance loop of
+*                   generateCircuitBoard); unit = one matrix entry
+*
+* A kernel is repeated until a batch lasts about --min-ms / --batches, and
+* the median over batches is reported: ns and TSC cycles per call and per
+* unit, plus bandwidth over the bytes the kernel must touch (matrix
+* entries, tour positions, list entries; cache lines pulled in along with
+* them are not counted). Cycles come from rdtsc, a constant-rate counter on
+* current x86 CPUs, so they track wall time at the nominal frequency rather
+* than core cycles under turbo; other targets report ns only.
+*
+* Usage: kernel_bench [--sizes=50,100,...] [--panel] [--kernels=name,...]
+*                     [--min-ms=MS] [--batches=N] [--csv=FILE]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdint>
+#include "TSPSolver.h"
+#include "data_generator.h"
+#include "panel_generator.h"
+#include "bench_stats.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define HAVE_TSC 1
+#elif defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define HAVE_TSC 1
+#else
+#define HAVE_TSC 0
+#endif
+
+namespace {
+    uint64_t readTsc() {
+#if HAVE_TSC
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    // Keeps kernel results alive without affecting the measured code
+    volatile double sink;
+
+    // Exposes the protected kernels
+    class KernelProbe : public TSPSolver {
+    public:
+        explicit KernelProbe(unsigned seed) : TSPSolver(seed) {}
+        using TSPSolver::Move;
+        using TSPSolver::findBestNeighbor;
+        using TSPSolver::calculateMoveCost;
+        using TSPSolver::isTabu;
+        using TSPSolver::applyMove;
+        using TSPSolver::updateTabuList;
+        using TSPSolver::initializeMemoryStructures;
+    };
+
+    struct Measurement {
+        double ns_per_call;
+        double cycles_per_call;   // 0 without a TSC
+    };
+
+    struct BenchSettings {
+        double min_ms;
+        int batches;
+    };
+
+    // Median over batches of `op` repeated enough to fill min_ms in total
+    template <typename Op>
+    Measurement measure(Op&& op, const BenchSettings& settings) {
+        using Clock = std::chrono::steady_clock;
+        op();   // warm caches and branch predictors
+
+        auto probe_start = Clock::now();
+        op();
+        double one_ns = std::max(1.0, static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - probe_start).count()));
+        double batch_ns = settings.min_ms * 1e6 / settings.batches;
+        long reps = std::max(1L, static_cast<long>(batch_ns / one_ns));
+
+        std::vector<double> ns, cycles;
+        for (int b = 0; b < settings.batches; b++) {
+            auto start = Clock::now();
+            uint64_t tsc_start = readTsc();
+            for (long r = 0; r < reps; r++) op();
+            uint64_t tsc_end = readTsc();
+            auto end = Clock::now();
+            ns.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()
+                / static_cast<double>(reps));
+            cycles.push_back(static_cast<double>(tsc_end - tsc_start) / reps);
+        }
+        return { SampleSummary::of(ns).median, SampleSummary::of(cycles).median };
+    }
+
+    struct Row {
+        std::string kernel;
+        std::string costs;
+        int n;
+        Measurement m;
+        double units;            // per call
+        double bytes;            // touched per call
+    };
+
+    void printRow(const Row& r) {
+        std::cout << std::left << std::setw(14) << r.kernel << std::setw(7) << r.costs
+            << std::right << std::setw(7) << r.n << std::fixed << std::setprecision(1)
+            << std::setw(14) << r.m.ns_per_call
+            << std::setw(14) << r.m.cycles_per_call
+            << std::setw(14) << std::setprecision(0) << r.units
+            << std::setw(12) << std::setprecision(3) << r.m.cycles_per_call / r.units
+            << std::setw(10) << std::setprecision(2) << r.bytes / r.m.ns_per_call << "\n";
+    }
+
+    std::vector<TSPGenerator::Point> randomHoles(int n, std::mt19937& rng) {
+        // Board area grows with n, like real panels at constant density
+        double side = 10.0 * std::sqrt(static_cast<double>(n));
+        std::uniform_real_distribution<double> coordinate(0.0, side);
+        std::vector<TSPGenerator::Point> holes;
+        holes.reserve(n);
+        for (int i = 0; i < n; i++) holes.emplace_back(coordinate(rng), coordinate(rng));
+        return holes;
+    }
+
+    // Panel of about n holes, cut to n where the last board overshoots
+    std::vector<TSPGenerator::Point> panelHoles(int n, unsigned seed) {
+        auto holes = PanelGenerator::generate(PanelGenerator::specForHoleCount(n), seed).holes;
+        if (static_cast<int>(holes.size()) > n) holes.resize(n);
+        return holes;
+    }
+
+    bool selected(const std::vector<std::string>& kernels, const std::string& name) {
+        return kernels.empty() || std::find(kernels.begin(), kernels.end(), name) != kernels.end();
+    }
+
+    std::vector<std::string> splitList(const std::string& list) {
+        std::vector<std::string> items;
+        std::stringstream ss(list);
+        std::string item;
+        while (std::getline(ss, item, ',')) {
+            if (!item.empty()) items.push_back(item);
+        }
+        return items;
+    }
+
+    // Kernels that read the cost matrix, for one cost type
+    template <typename T>
+    void benchMatrixKernels(const TSP& tsp, int n, const char* costs, const std::vector<std::string>& kernels,
+        const BenchSettings& settings, std::mt19937& rng, std::vector<Row>& rows) {
+        const int tenure = 20;
+
+        KernelProbe probe(rng());
+        probe.setTabuTenure(tenure);
+        probe.initializeMemoryStructures(n);
+        TSPSolution sol(tsp);
+        probe.initRnd(sol);
+        const int m = static_cast<int>(sol.sequence.size());   // n + 1, depot at both ends
+
+        std::uniform_int_distribution<int> node(1, n - 1);
+        for (int i = 0; i < tenure; i++) {
+            probe.updateTabuList(node(rng), node(rng), i);
+        }
+
+        std::vector<KernelProbe::Move> moves(1024);
+        for (auto& move : moves) {
+            int a = std::uniform_int_distribution<int>(1, m - 3)(rng);
+            int b = std::uniform_int_distribution<int>(a + 1, m - 2)(rng);
+            move = KernelProbe::Move(a, b);
+        }
+
+        if (selected(kernels, "move_cost") && !std::is_integral<T>::value) {
+            std::size_t k = 0;
+            Measurement r = measure([&] {
+                sink = probe.calculateMoveCost(tsp, sol, moves[k++ & 1023]);
+            }, settings);
+            rows.push_back({ "move_cost", costs, n, r, 1.0, 4.0 * (sizeof(T) + sizeof(int)) });
+            printRow(rows.back());
+        }
+
+        if (selected(kernels, "best_neighbor")) {
+            double candidates = static_cast<double>(m - 3) * (m - 2) / 2.0;
+            Measurement r = measure([&] {
+                sink = probe.findBestNeighbor(tsp, sol, 0).cost_change;
+            }, settings);
+            // Two cost entries and the next tour position per candidate, the
+            // cached edge per candidate row
+            rows.push_back({ "best_neighbor", costs, n, r, candidates,
+                candidates * (2 * sizeof(T) + sizeof(int)) + (m - 1) * 2 * sizeof(T) });
+            printRow(rows.back());
+        }
+
+        if (selected(kernels, "evaluate")) {
+            Measurement r = measure([&] { sink = probe.evaluate(sol, tsp); }, settings);
+            rows.push_back({ "evaluate", costs, n, r, static_cast<double>(m - 1),
+                static_cast<double>(m - 1) * (sizeof(T) + sizeof(int)) });
+            printRow(rows.back());
+        }
+
+        if (std::is_integral<T>::value) return;
+
+        if (selected(kernels, "is_tabu")) {
+            std::vector<std::pair<int, int>> queries(1024);
+            for (auto& q : queries) q = { node(rng), node(rng) };
+            std::size_t k = 0;
+            Measurement r = measure([&] {
+                const auto& q = queries[k++ & 1023];
+                sink = probe.isTabu(q.first, q.second, 0);
+            }, settings);
+            rows.push_back({ "is_tabu", "-", n, r, static_cast<double>(tenure),
+                tenure * 2.0 * sizeof(int) });
+            printRow(rows.back());
+        }
+
+        if (selected(kernels, "apply_move")) {
+            double elements = 0;
+            for (const auto& move : moves) elements += move.to - move.from + 1;
+            elements /= moves.size();
+            std::size_t k = 0;
+            Measurement r = measure([&] {
+                probe.applyMove(sol, moves[k++ & 1023]);
+                sink = sol.sequence[1];
+            }, settings);
+            rows.push_back({ "apply_move", "-", n, r, elements, elements * 2 * sizeof(int) });
+            printRow(rows.back());
+        }
+    }
+}
+
+int main(int argc, char const* argv[]) {
+    std::vector<int> sizes = { 50, 100, 200, 500, 1000, 2000, 5000, 10000 };
+    std::vector<std::string> kernels;
+    BenchSettings settings{ 200.0, 7 };
+    std::string csv_file;
+    bool panels = false;
+
+    for (int a = 1; a < argc; a++) {
+        std::string arg(argv[a]);
+        if (arg.rfind("--sizes=", 0) == 0) {
+            sizes.clear();
+            for (const auto& s : splitList(arg.substr(8))) sizes.push_back(std::max(4, std::stoi(s)));
+        }
+        else if (arg == "--panel") panels = true;
+        else if (arg.rfind("--kernels=", 0) == 0) kernels = splitList(arg.substr(10));
+        else if (arg.rfind("--min-ms=", 0) == 0) settings.min_ms = std::stod(arg.substr(9));
+        else if (arg.rfind("--batches=", 0) == 0) settings.batches = std::max(1, std::stoi(arg.substr(10)));
+        else if (arg.rfind("--csv=", 0) == 0) csv_file = arg.substr(6);
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+
+#if HAVE_TSC
+    // Nominal TSC rate, to relate cycles to ns
+    auto clock_start = std::chrono::steady_clock::now();
+    uint64_t tsc_start = readTsc();
+    while (std::chrono::steady_clock::now() - clock_start < std::chrono::milliseconds(50)) {}
+    double tsc_ghz = (readTsc() - tsc_start) / static_cast<double>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - clock_start).count());
+    std::cout << "TSC: " << std::fixed << std::setprecision(2) << tsc_ghz << " GHz\n";
+#else
+    std::cout << "TSC: not available, cycles reported as 0\n";
+#endif
+
+    std::cout << std::left << std::setw(14) << "kernel" << std::setw(7) << "costs" << std::right
+        << std::setw(7) << "n" << std::setw(14) << "ns/call" << std::setw(14) << "cycles/call"
+        << std::setw(14) << "units/call" << std::setw(12) << "cyc/unit" << std::setw(10) << "GB/s" << "\n";
+
+    std::mt19937 rng(12345);
+    std::vector<Row> rows;
+    try {
+        for (int size : sizes) {
+            auto holes = panels ? panelHoles(size, rng()) : randomHoles(size, rng);
+            const int n = static_cast<int>(holes.size());
+            if (n < 4) continue;
+            const double tick = TSP::MICROMETRE;
+
+            if (selected(kernels, "distances")) {
+                Measurement r = measure([&] {
+                    sink = TSPGenerator::computeDistances(holes, 1)[n - 1][0];
+                }, settings);
+                rows.push_back({ "distances", "double", n, r, static_cast<double>(n) * n,
+                    static_cast<double>(n) * n * sizeof(double) });
+                printRow(rows.back());
+                r = measure([&] {
+                    sink = TSPGenerator::computeIntegerDistances(holes, tick, 1)[n - 1][0];
+                }, settings);
+                rows.push_back({ "distances", "int32", n, r, static_cast<double>(n) * n,
+                    static_cast<double>(n) * n * sizeof(int32_t) });
+                printRow(rows.back());
+            }
+
+            // One matrix alive at a time keeps n = 10000 within 1 GB. Both cost
+            // types get the same tour, tabu list and moves, so they compare paired
+            const unsigned kernel_seed = rng();
+            {
+                TSP tsp;
+                tsp.cost = TSPGenerator::computeDistances(holes);
+                tsp.n = n;
+                std::mt19937 kernel_rng(kernel_seed);
+                benchMatrixKernels<double>(tsp, n, "double", kernels, settings, kernel_rng, rows);
+            }
+            {
+                TSP tsp;
+                tsp.setIntegerCosts(TSPGenerator::computeIntegerDistances(holes, tick), tick);
+                std::mt19937 kernel_rng(kernel_seed);
+                benchMatrixKernels<int32_t>(tsp, n, "int32", kernels, settings, kernel_rng, rows);
+            }
+        }
+    }
+    catch (std::exception& e) {
+        std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+        return 1;
+    }
+
+    if (!csv_file.empty()) {
+        std::ofstream csv(csv_file);
+        if (!csv) {
+            std::cerr << "Cannot write " << csv_file << "\n";
+            return 1;
+        }
+        csv << "kernel,costs,n,ns_per_call,cycles_per_call,units_per_call,cycles_per_unit,ns_per_unit,gb_per_s\n"
+            << std::setprecision(6);
+        for (const auto& r : rows) {
+            csv << r.kernel << "," << r.costs << "," << r.n << "," << r.m.ns_per_call << ","
+                << r.m.cycles_per_call << "," << r.units << "," << r.m.cycles_per_call / r.units << ","
+                << r.m.ns_per_call / r.units << "," << r.bytes / r.m.ns_per_call << "\n";
+        }
+        std::cout << "Results written to " << csv_file << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,320 @@
+/**
+* @file tsp_bench.cpp
+* @brief Benchmark harness for the tabu search solver
+*
+* Solves a fixed set of generated boards repeatedly and reports statistics
+* meant for regression tracking:
+* - boards are generated from fixed seeds, one per configuration, so every
+*   invocation measures the same instances
+* - every run uses a fresh TSPSolver seeded with base seed + run, so no
+*   reactive state is shared between runs; --warmup runs are discarded
+* - run times come from std::chrono::steady_clock in nanoseconds, on a
+*   solve without a SearchTrace, so tracing costs do not show up as solver
+*   time
+* - per board: median, 10th/90th percentiles and 95% confidence intervals
+*   of time and gap to the Held-Karp 1-tree bound (see bench_stats.h)
+* - time-to-target: for each run, the time at which the search first
+*   reached a tour within --target percent of the bound, read from a
+*   SearchTrace; the empirical distribution of these times is the
+*   time-to-target curve (Aiex, Resende and Ribeiro 2002). The trace comes
+*   from a second solve with the same seed, which follows the same
+*   trajectory; its times include the recording overhead
+*
+* --panel=N[,N...] replaces the default boards with PanelGenerator panels of
+* about N holes each, to measure the solver at production sizes. The solver
+* needs the dense cost matrix (8 n^2 bytes), which bounds n by memory, and a
+* 2-opt scan is O(n^2) per iteration, so lower --runs accordingly.
+*
+* Parameters come from the calibration store (--parameters, default
+* results/parameter_store.txt) when it exists and was calibrated for the
+* same cost model on real costs, else from the size-class defaults. Output
+* goes to --out (default results/bench):
+*   runs.csv      one line per measured run
+*   summary.csv   one line per board
+*   summary.json  the same, plus the time-to-target curves
+*   ttt.csv       sorted time-to-target per board with its probability
+*
+* Usage: tsp_bench [--runs=N] [--warmup=N] [--seed=S] [--target=PCT]
+*                  [--cost-model=NAME] [--panel=N,...] [--parameters=FILE]
+*                  [--out=DIR]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <tuple>
+#include <sstream>
+#include <chrono>
+#include <limits>
+#include <cmath>
+#include <algorithm>
+#include <stdexcept>
+#include <filesystem>
+#include "TSPSolver.h"
+#include "lower_bound.h"
+#include "data_generator.h"
+#include "panel_generator.h"
+#include "cost_model.h"
+#include "instance_features.h"
+#include "parameter_calibration.h"
+#include "parameter_store.h"
+#include "search_trace.h"
+#include "bench_stats.h"
+
+namespace {
+    struct BenchBoard {
+        std::string name;
+        std::vector<TSPGenerator::Point> holes;
+        InstanceFeatures features;
+    };
+
+    struct RunRecord {
+        int run;
+        unsigned seed;
+        double time_ms;
+        double cost;
+        double gap;
+        double ttt_ms;      // infinity if the target was not reached
+    };
+
+    struct BoardReport {
+        std::string name;
+        int holes;
+        double bound;
+        double target;
+        ParameterCalibration::ClassParameters params;
+        std::vector<RunRecord> runs;
+        SampleSummary time;
+        SampleSummary gap;
+        SampleSummary ttt;          // over the runs that reached the target
+        std::vector<double> ttt_sorted;
+    };
+
+    void writeSummaryJson(std::ostream& out, const char* key, const SampleSummary& s) {
+        out << "\"" << key << "\": {\"n\": " << s.n << ", \"mean\": " << s.mean
+            << ", \"stddev\": " << s.stddev << ", \"ci95\": [" << s.ci_low << ", " << s.ci_high
+            << "], \"min\": " << s.min << ", \"p10\": " << s.p10 << ", \"median\": " << s.median
+            << ", \"median_ci95\": [" << s.median_ci_low << ", " << s.median_ci_high
+            << "], \"p90\": " << s.p90 << ", \"max\": " << s.max << "}";
+    }
+}
+
+int main(int argc, char const* argv[]) {
+    int runs = 30;
+    int warmup = 1;
+    unsigned seed = 1;
+    double target_gap = 5.0;
+    std::string parameters_file = "results/parameter_store.txt";
+    std::string out_dir = "results/bench";
+    CostModel cost_model;
+    std::vector<int> panel_sizes;
+
+    try {
+        for (int a = 1; a < argc; a++) {
+            std::string arg(argv[a]);
+            if (arg.rfind("--runs=", 0) == 0) runs = std::max(1, std::stoi(arg.substr(7)));
+            else if (arg.rfind("--warmup=", 0) == 0) warmup = std::max(0, std::stoi(arg.substr(9)));
+            else if (arg.rfind("--seed=", 0) == 0) seed = std::stoul(arg.substr(7));
+            else if (arg.rfind("--target=", 0) == 0) target_gap = std::stod(arg.substr(9));
+            else if (arg.rfind("--parameters=", 0) == 0) parameters_file = arg.substr(13);
+            else if (arg.rfind("--out=", 0) == 0) out_dir = arg.substr(6);
+            else if (arg.rfind("--cost-model=", 0) == 0) cost_model = CostModel(CostModel::parse(arg.substr(13)));
+            else if (arg.rfind("--panel=", 0) == 0) {
+                std::stringstream list(arg.substr(8));
+                std::string size;
+                while (std::getline(list, size, ',')) {
+                    if (!size.empty()) panel_sizes.push_back(std::max(4, std::stoi(size)));
+                }
+            }
+            else {
+                std::cerr << "Unknown option " << arg << "\n";
+                return 1;
+            }
+        }
+
+        ParameterStore store(parameters_file, cost_model);
+        bool calibrated = store.load() && !store.empty();
+        std::cout << (calibrated ? "Parameters from " + parameters_file : std::string("Default parameters"))
+            << ", " << runs << " runs (+" << warmup << " warmup) per board, target "
+            << target_gap << "% over the 1-tree bound\n";
+
+        const std::vector<std::tuple<int, int, int>> board_configs = {
+            {50, 50, 2}, {75, 75, 3}, {100, 100, 3}, {125, 125, 4}, {150, 150, 5}
+        };
+
+        std::vector<BenchBoard> boards;
+        if (panel_sizes.empty()) {
+            for (std::size_t b = 0; b < board_configs.size(); b++) {
+                int width = std::get<0>(board_configs[b]);
+                int height = std::get<1>(board_configs[b]);
+                int components = std::get<2>(board_configs[b]);
+
+                BenchBoard board;
+                std::vector<BoardPattern> placed;
+                board.holes = TSPGenerator::generateHoles(width, height, components,
+                    seed * 1000003u + static_cast<unsigned>(b) + 1, &placed);
+                board.name = std::to_string(width) + "x" + std::to_string(height);
+                board.features = InstanceFeatures::fromBoard(width, height, board.holes.size(), placed);
+                boards.push_back(std::move(board));
+            }
+        }
+        for (std::size_t b = 0; b < panel_sizes.size(); b++) {
+            auto panel = PanelGenerator::generate(PanelGenerator::specForHoleCount(panel_sizes[b]),
+                seed * 1000003u + static_cast<unsigned>(b) + 1);
+            std::vector<BoardPattern> placed;
+            for (int k = 0; k < PanelGenerator::NUM_BOARD_PATTERNS; k++) {
+                placed.insert(placed.end(), panel.component_counts[k], static_cast<BoardPattern>(k));
+            }
+
+            BenchBoard board;
+            board.name = "panel" + std::to_string(panel_sizes[b]);
+            board.features = InstanceFeatures::fromBoard(panel.width, panel.height, panel.holes.size(), placed);
+            board.holes = std::move(panel.holes);
+            boards.push_back(std::move(board));
+        }
+
+        std::vector<BoardReport> reports;
+        for (const BenchBoard& board : boards) {
+            TSP tsp;
+            tsp.cost = cost_model.buildMatrix(board.holes);
+            tsp.n = static_cast<int>(tsp.cost.size());
+
+            BoardReport report;
+            report.name = board.name;
+            report.holes = tsp.n;
+            report.params = calibrated
+                ? store.lookup(board.features)
+                : ParameterCalibration::Parameters().forSize(tsp.n);
+            report.bound = tsp.toLength(HeldKarpBound().compute(tsp).bound);
+            report.target = report.bound * (1.0 + target_gap / 100.0);
+
+            // One record per iteration keeps the whole run for time-to-target
+            SearchTrace trace(static_cast<std::size_t>(std::max(report.params.iterations, 1)));
+            std::vector<double> times, gaps;
+            for (int run = -warmup; run < runs; run++) {
+                unsigned run_seed = seed + static_cast<unsigned>(run + warmup);
+                TSPSolver solver(run_seed);
+                report.params.applyTo(solver);
+
+                TSPSolution initial(tsp);
+                TSPSolution best(tsp);
+                solver.initRnd(initial);
+
+                auto start = std::chrono::steady_clock::now();
+                solver.solveWithTabuSearch(tsp, initial, best);
+                auto end = std::chrono::steady_clock::now();
+                if (run < 0) continue;
+
+                // Same seed, same trajectory, recorded for time-to-target only
+                TSPSolver traced(run_seed);
+                report.params.applyTo(traced);
+                traced.setSearchTrace(&trace);
+                TSPSolution traced_initial(tsp);
+                TSPSolution traced_best(tsp);
+                traced.initRnd(traced_initial);
+                traced.solveWithTabuSearch(tsp, traced_initial, traced_best);
+
+                RunRecord r;
+                r.run = run;
+                r.seed = run_seed;
+                r.time_ms = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / 1e6;
+                r.cost = tsp.toLength(solver.evaluate(best, tsp));
+                r.gap = HeldKarpBound::gap(r.cost, report.bound);
+                r.ttt_ms = std::numeric_limits<double>::infinity();
+                for (const auto& record : trace.getRecords()) {
+                    if (record.cost <= report.target) {
+                        r.ttt_ms = record.elapsed_us / 1000.0;
+                        break;
+                    }
+                }
+                report.runs.push_back(r);
+                times.push_back(r.time_ms);
+                gaps.push_back(r.gap);
+                if (std::isfinite(r.ttt_ms)) report.ttt_sorted.push_back(r.ttt_ms);
+            }
+
+            report.time = SampleSummary::of(times);
+            report.gap = SampleSummary::of(gaps);
+            report.ttt = SampleSummary::of(report.ttt_sorted);
+            std::sort(report.ttt_sorted.begin(), report.ttt_sorted.end());
+
+            std::cout << std::fixed << std::setprecision(3)
+                << "  " << report.name << " (" << report.holes << " holes): time median "
+                << report.time.median << " ms [" << report.time.median_ci_low << ", "
+                << report.time.median_ci_high << "], p90 " << report.time.p90
+                << " ms; gap median " << std::setprecision(2) << report.gap.median
+                << "%; target reached " << report.ttt.n << "/" << report.runs.size();
+            if (report.ttt.n > 0) {
+                std::cout << ", median " << std::setprecision(3) << report.ttt.median << " ms";
+            }
+            std::cout << "\n";
+            reports.push_back(report);
+        }
+
+        std::filesystem::create_directories(out_dir);
+        std::ofstream runs_csv(out_dir + "/runs.csv");
+        std::ofstream summary_csv(out_dir + "/summary.csv");
+        std::ofstream ttt_csv(out_dir + "/ttt.csv");
+        std::ofstream json(out_dir + "/summary.json");
+        if (!runs_csv || !summary_csv || !ttt_csv || !json) {
+            throw std::runtime_error("Cannot write benchmark results to " + out_dir);
+        }
+        for (auto* out : { &runs_csv, &summary_csv, &ttt_csv, &json }) {
+            *out << std::setprecision(6) << std::defaultfloat;
+        }
+
+        runs_csv << "board,holes,run,seed,time_ms,cost,gap_pct,ttt_ms\n";
+        summary_csv << "board,holes,runs,bound,target,time_median_ms,time_median_ci_low,time_median_ci_high,"
+            << "time_p10_ms,time_p90_ms,time_mean_ms,time_mean_ci_low,time_mean_ci_high,"
+            << "gap_median_pct,gap_p90_pct,gap_mean_pct,target_hits,ttt_median_ms,ttt_p90_ms\n";
+        ttt_csv << "board,rank,ttt_ms,probability\n";
+        json << "{\n  \"cost_model\": \"" << cost_model.name() << "\",\n  \"runs\": " << runs
+            << ",\n  \"warmup\": " << warmup << ",\n  \"seed\": " << seed
+            << ",\n  \"target_gap_pct\": " << target_gap << ",\n  \"boards\": [\n";
+
+        for (std::size_t i = 0; i < reports.size(); i++) {
+            const BoardReport& r = reports[i];
+            for (const auto& run : r.runs) {
+                runs_csv << r.name << "," << r.holes << "," << run.run << "," << run.seed << ","
+                    << run.time_ms << "," << run.cost << "," << run.gap << ",";
+                if (std::isfinite(run.ttt_ms)) runs_csv << run.ttt_ms;
+                runs_csv << "\n";
+            }
+
+            summary_csv << r.name << "," << r.holes << "," << r.runs.size() << "," << r.bound << ","
+                << r.target << "," << r.time.median << "," << r.time.median_ci_low << ","
+                << r.time.median_ci_high << "," << r.time.p10 << "," << r.time.p90 << ","
+                << r.time.mean << "," << r.time.ci_low << "," << r.time.ci_high << ","
+                << r.gap.median << "," << r.gap.p90 << "," << r.gap.mean << "," << r.ttt.n << ",";
+            if (r.ttt.n > 0) summary_csv << r.ttt.median << "," << r.ttt.p90;
+            else summary_csv << ",";
+            summary_csv << "\n";
+
+            // Empirical CDF over all measured runs; misses never reach p = 1
+            json << "    {\"board\": \"" << r.name << "\", \"holes\": " << r.holes
+                << ", \"bound\": " << r.bound << ", \"target\": " << r.target << ",\n     ";
+            writeSummaryJson(json, "time_ms", r.time);
+            json << ",\n     ";
+            writeSummaryJson(json, "gap_pct", r.gap);
+            json << ",\n     ";
+            writeSummaryJson(json, "ttt_ms", r.ttt);
+            json << ",\n     \"ttt_curve\": [";
+            for (std::size_t k = 0; k < r.ttt_sorted.size(); k++) {
+                double p = (k + 0.5) / r.runs.size();
+                ttt_csv << r.name << "," << k + 1 << "," << r.ttt_sorted[k] << "," << p << "\n";
+                json << (k ? ", " : "") << "[" << r.ttt_sorted[k] << ", " << p << "]";
+            }
+            json << "]}" << (i + 1 < reports.size() ? "," : "") << "\n";
+        }
+        json << "  ]\n}\n";
+
+        std::cout << "Results written to " << out_dir << "\n";
+        return 0;
+    }
+    catch (std::exception& e) {
+        std::cout << ">>>EXCEPTION: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -6,6 +6,13 @@
 * While it includes a read() method for file input, the current implementation
 * primarily uses the TSPGenerator for instance creation.
 *
+* Costs are held in one of two modes:
+* - Real mode: cost[i][j] in mm (double)
+* - Integer mode: icost[i][j] in ticks of `unit` cost units (int32, e.g.
+*   micrometres for a machine with 1 um positional resolution, or
+*   microseconds with a time-based CostModel). Tour values and move deltas
+*   are then exact integers, and the matrix takes half the memory. Solver
+*   values are expressed in ticks; toLength() converts back to cost units.
 */
 
 #ifndef TSP_H
@@ -16,13 +23,38 @@
 #include <iostream>
 #include <fstream>
 #include <vector>
+#include <cstdint>
 
 class TSP {
 public:
-    TSP() : n(0), infinite(1e10) {}
+    static constexpr double MICROMETRE = 0.001;  // mm per tick
+
+    TSP() : n(0), infinite(1e10), integer_costs(false), unit(1.0) {}
     int n;  // number of nodes/holes
     std::vector<std::vector<double>> cost;  // cost matrix
     double infinite;  // upper bound value for invalid solutions
+
+    bool integer_costs;  // true when icost holds the instance
+    double unit;         // cost units (mm or s) per integer tick
+    std::vector<std::vector<int32_t>> icost;  // integer cost matrix
+
+    // Switches the instance to integer mode; the real matrix is released
+    void setIntegerCosts(std::vector<std::vector<int32_t>> costs, double tick_mm) {
+        n = static_cast<int>(costs.size());
+        icost = std::move(costs);
+        std::vector<std::vector<double>>().swap(cost);
+        integer_costs = true;
+        unit = tick_mm;
+    }
+
+    double arc(int i, int j) const {
+        return integer_costs ? static_cast<double>(icost[i][j]) : cost[i][j];
+    }
+
+    // Converts a solver value (tour length or delta) to cost units
+    double toLength(double value) const {
+        return integer_costs ? value * unit : value;
+    }
 };
 
-#endif /* TSP_H */
\ No newline at end of file
+#endif /* TSP_H */
@@ -5,33 +5,44 @@
 #include <deque>
 #include <limits>
 #include <map>
+#include <cstdint>
+#include <type_traits>
+#include <random>
 #include "TSPSolution.h"
 #include "TSP.h"
 
+class SnapshotWriter;
+class SearchTrace;
+
 class TSPSolver {
 public:
-    TSPSolver();
+    // seed == 0 draws a random seed; a fixed seed makes runs repeatable
+    explicit TSPSolver(unsigned seed = 0);
     double evaluate(const TSPSolution& sol, const TSP& tsp) const;
     bool initRnd(TSPSolution& sol);
     bool solveWithTabuSearch(const TSP& tsp, const TSPSolution& initSol,
-        TSPSolution& bestSol,
-        const std::vector<std::pair<double, double>>& points,
-        int save_every = 100);
+        TSPSolution& bestSol, int save_every = 100);
 
-    void setTabuTenure(int tenure) { tabu_tenure = tenure; }
+    void setTabuTenure(int tenure) { tabu_tenure = initial_tabu_tenure = tenure; }
     void setMaxIterations(int iterations) { max_iterations = iterations; }
+    void setSeed(unsigned seed) { rng.seed(seed); }
+    // Every save_every iterations the current tour is offered to the writer;
+    // nullptr (the default) disables snapshots
+    void setSnapshotWriter(SnapshotWriter* writer) { snapshots = writer; }
+    // Records every iteration into the trace; nullptr (the default) disables it
+    void setSearchTrace(SearchTrace* search_trace) { trace = search_trace; }
 
-protected:
-    // Enhanced search statistics
-    struct SearchStats {
-        int iteration;
-        double solution_value;
-        int current_tenure;
-        bool was_improvement;
-        double improvement_percentage;
-        double time_elapsed;
-    };
+    // Reactive search knobs, tuned by ParameterCalibration
+    void setTenureRange(int min, int max) { min_tenure = min; max_tenure = max; }
+    void setMaxIterationsWithoutImprovement(int iterations) {
+        max_iterations_without_improvement = iterations;
+    }
+    void setIntensificationIterations(int iterations) { intensification_iterations = iterations; }
 
+    // Iterations the last search ran; a deterministic measure of its work
+    int getIterations() const { return iterations_run; }
+
+protected:
     // Move tracking structure
     struct MoveFrequency {
         int from, to;
@@ -48,19 +59,35 @@ protected:
             : from(f), to(t), cost_change(cost) {}
     };
 
-    // Core parameters
+    // Core parameters; every search starts from initial_tabu_tenure
+    int initial_tabu_tenure;
     int tabu_tenure;
     int max_iterations;
+    int iterations_run;
     std::deque<std::pair<int, int>> tabu_list;
     std::map<std::pair<int, int>, MoveFrequency> move_history;
 
     // Reactive parameters
     int min_tenure;
     int max_tenure;
+    int max_iterations_without_improvement;  // stagnation before diversifying
+    int intensification_iterations;          // length of an intensification phase
     int iterations_without_improvement;
     double best_known_value;
     bool in_intensification_phase;
-    std::vector<SearchStats> search_history;
+
+    // Minimum decrease that counts as an improvement. For real costs it is
+    // IMPROVEMENT_FRACTION of the mean arc cost, so mm and seconds behave
+    // alike (0.004-0.012 mm on the generated boards); for integer costs it is
+    // half a tick, since deltas are exact there
+    double improvement_threshold;
+
+    // Per-solver generator for the random start and diversification, so
+    // solvers running on different threads never share state
+    std::mt19937 rng;
+
+    SnapshotWriter* snapshots;
+    SearchTrace* trace;
 
     // Memory structures
     std::vector<std::vector<int>> frequency_matrix;
@@ -68,10 +95,8 @@ protected:
     double best_intensification_value;
 
     // Constants
-    static const int MAX_ITERATIONS_WITHOUT_IMPROVEMENT;
-    static const int INTENSIFICATION_ITERATIONS;
     static const int MIN_MOVES_FOR_STATS;
-    static const double IMPROVEMENT_THRESHOLD;
+    static const double IMPROVEMENT_FRACTION;
 
     // Core methods
     Move findBestNeighbor(const TSP& tsp, const TSPSolution& currSol, int iteration);
@@ -80,6 +105,13 @@ protected:
     TSPSolution& applyMove(TSPSolution& tspSol, const Move& move);
     double calculateMoveCost(const TSP& tsp, const TSPSolution& sol, const Move& move);
 
+    // Cost-type specific kernels (double mm or int32 ticks)
+    template <typename T>
+    Move scanTwoOpt(const std::vector<std::vector<T>>& cost, const TSPSolution& currSol,
+        int iteration, double infinite);
+    template <typename T>
+    static double tourLength(const std::vector<std::vector<T>>& cost, const TSPSolution& sol);
+
     // Enhanced reactive methods
     void adjustTabuTenure(double current_value);
     void intensifySearch(const TSP& tsp, TSPSolution& current_sol);
@@ -90,8 +122,6 @@ protected:
     // New helper methods
     void initializeMemoryStructures(int size);
     void updateMoveFrequency(const Move& move, double improvement);
-    void updateSearchStats(int iteration, double current_value,
-        double previous_value, double time_elapsed);
 };
 
 #endif /* TSPSOLVER_H */
\ No newline at end of file
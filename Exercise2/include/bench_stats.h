@@ -0,0 +1,94 @@
+/**
+* @file bench_stats.h
+* @brief Summary statistics for repeated benchmark measurements
+*
+* SampleSummary::of() reduces a sample (run times, costs, gaps) to
+* - mean and sample standard deviation, with a 95% confidence interval for
+*   the mean from Student's t distribution
+* - min, 10th/50th/90th percentiles (linear interpolation) and max
+* - a distribution-free 95% confidence interval for the median from order
+*   statistics (normal approximation to the binomial ranks)
+* The median and its interval are the numbers to compare across versions:
+* they are not moved by the occasional slow run (page faults, scheduling).
+*/
+
+#ifndef BENCH_STATS_H
+#define BENCH_STATS_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+struct SampleSummary {
+    std::size_t n;
+    double mean;
+    double stddev;
+    double ci_low;          // 95% CI of the mean
+    double ci_high;
+    double min;
+    double p10;
+    double median;
+    double p90;
+    double max;
+    double median_ci_low;   // 95% CI of the median
+    double median_ci_high;
+
+    SampleSummary() : n(0), mean(0), stddev(0), ci_low(0), ci_high(0), min(0), p10(0),
+        median(0), p90(0), max(0), median_ci_low(0), median_ci_high(0) {}
+
+    // q in [0, 1], values sorted ascending and non-empty
+    static double percentile(const std::vector<double>& sorted, double q) {
+        double pos = q * (sorted.size() - 1);
+        std::size_t lo = static_cast<std::size_t>(std::floor(pos));
+        std::size_t hi = std::min(lo + 1, sorted.size() - 1);
+        return sorted[lo] + (pos - lo) * (sorted[hi] - sorted[lo]);
+    }
+
+    // Two-sided 95% critical value of Student's t
+    static double tCritical95(std::size_t df) {
+        static const double table[] = { 12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+            2.262, 2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+            2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042 };
+        if (df == 0) return 0.0;
+        if (df <= 30) return table[df - 1];
+        if (df <= 60) return 2.000;
+        if (df <= 120) return 1.980;
+        return 1.960;
+    }
+
+    static SampleSummary of(std::vector<double> values) {
+        SampleSummary s;
+        s.n = values.size();
+        if (values.empty()) return s;
+        std::sort(values.begin(), values.end());
+
+        double sum = 0.0;
+        for (double v : values) sum += v;
+        s.mean = sum / s.n;
+        double squares = 0.0;
+        for (double v : values) squares += (v - s.mean) * (v - s.mean);
+        s.stddev = s.n > 1 ? std::sqrt(squares / (s.n - 1)) : 0.0;
+        double half_width = tCritical95(s.n - 1) * s.stddev / std::sqrt(static_cast<double>(s.n));
+        s.ci_low = s.mean - half_width;
+        s.ci_high = s.mean + half_width;
+
+        s.min = values.front();
+        s.max = values.back();
+        s.p10 = percentile(values, 0.10);
+        s.median = percentile(values, 0.50);
+        s.p90 = percentile(values, 0.90);
+
+        // Ranks n/2 -+ 1.96 sqrt(n)/2 (1-based), clamped to the sample
+        double spread = 1.96 * std::sqrt(static_cast<double>(s.n)) / 2.0;
+        long lo = static_cast<long>(std::floor(s.n / 2.0 - spread));
+        long hi = static_cast<long>(std::ceil(s.n / 2.0 + spread)) + 1;
+        lo = std::max(lo, 1L);
+        hi = std::min(hi, static_cast<long>(s.n));
+        s.median_ci_low = values[lo - 1];
+        s.median_ci_high = values[hi - 1];
+        return s;
+    }
+};
+
+#endif /* BENCH_STATS_H */
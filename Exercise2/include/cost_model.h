@@ -0,0 +1,169 @@
+/**
+* @file cost_model.h
+* @brief Pluggable drill-head travel cost models
+*
+* Costs between holes can be evaluated with different machine models:
+* - EUCLIDEAN:   straight-line distance (mm), the historical default
+* - MANHATTAN:   |dx| + |dy| (mm), axes moved one after the other
+* - CHEBYSHEV:   max(|dx|, |dy|) (mm), independent axes at constant speed
+* - TRAPEZOIDAL: travel time (s) with independent X/Y axes, each following a
+*                trapezoidal velocity profile (accelerate, cruise, brake);
+*                the move ends when the slower axis arrives
+*
+* Matrices are built through DistanceMatrix with the metric inlined as a
+* functor, so every model gets the vectorized, multi-threaded kernel. The
+* resulting std::vector<std::vector<double>> feeds both TSPModel (CPLEX) and
+* TSP/TSPSolver unchanged.
+*
+* Distance metrics are in mm; at a constant feed rate travel time is
+* proportional, so cycleTime() converts them with max_speed.
+*/
+
+#ifndef COST_MODEL_H
+#define COST_MODEL_H
+
+#include <vector>
+#include <string>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include <stdexcept>
+#include "distance_matrix.h"
+
+enum class CostMetric {
+    EUCLIDEAN,
+    MANHATTAN,
+    CHEBYSHEV,
+    TRAPEZOIDAL
+};
+
+// PCB drilling machine constants
+struct MachineKinematics {
+    double max_speed;      // mm/s, per axis
+    double acceleration;   // mm/s^2, per axis
+    double drill_time;     // seconds per hole
+
+    MachineKinematics(double speed = 50.0, double accel = 2000.0, double drill = 0.5)
+        : max_speed(speed), acceleration(accel), drill_time(drill) {}
+};
+
+struct ManhattanMetric {
+    double operator()(double dx, double dy) const {
+        return std::abs(dx) + std::abs(dy);
+    }
+};
+
+struct ChebyshevMetric {
+    double operator()(double dx, double dy) const {
+        return std::max(std::abs(dx), std::abs(dy));
+    }
+};
+
+struct TrapezoidalMetric {
+    double inv_accel;     // 1 / a
+    double inv_speed;     // 1 / v
+    double ramp_time;     // v / a, time to reach cruise speed
+    double ramp_dist;     // v^2 / a, shortest move that reaches cruise speed
+
+    explicit TrapezoidalMetric(const MachineKinematics& k)
+        : inv_accel(1.0 / k.acceleration), inv_speed(1.0 / k.max_speed),
+          ramp_time(k.max_speed / k.acceleration),
+          ramp_dist(k.max_speed * k.max_speed / k.acceleration) {}
+
+    double axisTime(double d) const {
+        d = std::abs(d);
+        // Triangular profile for short moves, trapezoidal otherwise
+        return d < ramp_dist ? 2.0 * std::sqrt(d * inv_accel) : d * inv_speed + ramp_time;
+    }
+
+    double operator()(double dx, double dy) const {
+        return std::max(axisTime(dx), axisTime(dy));
+    }
+};
+
+class CostModel {
+public:
+    explicit CostModel(CostMetric metric = CostMetric::EUCLIDEAN,
+        const MachineKinematics& kinematics = MachineKinematics())
+        : metric(metric), kinematics(kinematics) {}
+
+    CostMetric getMetric() const { return metric; }
+    const MachineKinematics& getKinematics() const { return kinematics; }
+
+    // Cost of a single move; for on-the-fly evaluation without a matrix
+    double operator()(double dx, double dy) const {
+        switch (metric) {
+        case CostMetric::MANHATTAN: return ManhattanMetric()(dx, dy);
+        case CostMetric::CHEBYSHEV: return ChebyshevMetric()(dx, dy);
+        case CostMetric::TRAPEZOIDAL: return TrapezoidalMetric(kinematics)(dx, dy);
+        default: return EuclideanMetric()(dx, dy);
+        }
+    }
+
+    template <typename PointT>
+    std::vector<std::vector<double>> buildMatrix(const std::vector<PointT>& points,
+        unsigned threads = 0) const {
+        switch (metric) {
+        case CostMetric::MANHATTAN:
+            return DistanceMatrix::build(points, threads, ManhattanMetric());
+        case CostMetric::CHEBYSHEV:
+            return DistanceMatrix::build(points, threads, ChebyshevMetric());
+        case CostMetric::TRAPEZOIDAL:
+            return DistanceMatrix::build(points, threads, TrapezoidalMetric(kinematics));
+        default:
+            return DistanceMatrix::build(points, threads, EuclideanMetric());
+        }
+    }
+
+    // Integer matrix in ticks of `tick` units() (e.g. 0.001 mm or 1e-6 s)
+    template <typename PointT>
+    std::vector<std::vector<int32_t>> buildIntegerMatrix(const std::vector<PointT>& points,
+        double tick, unsigned threads = 0) const {
+        switch (metric) {
+        case CostMetric::MANHATTAN:
+            return DistanceMatrix::buildInteger(points, tick, threads, ManhattanMetric());
+        case CostMetric::CHEBYSHEV:
+            return DistanceMatrix::buildInteger(points, tick, threads, ChebyshevMetric());
+        case CostMetric::TRAPEZOIDAL:
+            return DistanceMatrix::buildInteger(points, tick, threads, TrapezoidalMetric(kinematics));
+        default:
+            return DistanceMatrix::buildInteger(points, tick, threads, EuclideanMetric());
+        }
+    }
+
+    bool isTimeBased() const { return metric == CostMetric::TRAPEZOIDAL; }
+    std::string units() const { return isTimeBased() ? "s" : "mm"; }
+    // Integer-mode tick: 1 um, or 1 us for time-based models
+    double integerTick() const { return isTimeBased() ? 1e-6 : 1e-3; }
+
+    // Total machine time for a tour of the given cost over `holes` holes
+    double cycleTime(double tour_cost, int holes) const {
+        double travel = isTimeBased() ? tour_cost : tour_cost / kinematics.max_speed;
+        return travel + holes * kinematics.drill_time;
+    }
+
+    std::string name() const { return toString(metric); }
+
+    static std::string toString(CostMetric m) {
+        switch (m) {
+        case CostMetric::MANHATTAN: return "manhattan";
+        case CostMetric::CHEBYSHEV: return "chebyshev";
+        case CostMetric::TRAPEZOIDAL: return "trapezoidal";
+        default: return "euclidean";
+        }
+    }
+
+    static CostMetric parse(const std::string& name) {
+        for (CostMetric m : { CostMetric::EUCLIDEAN, CostMetric::MANHATTAN,
+                CostMetric::CHEBYSHEV, CostMetric::TRAPEZOIDAL }) {
+            if (toString(m) == name) return m;
+        }
+        throw std::invalid_argument("Unknown cost model: " + name);
+    }
+
+private:
+    CostMetric metric;
+    MachineKinematics kinematics;
+};
+
+#endif /* COST_MODEL_H */
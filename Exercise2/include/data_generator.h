@@ -15,6 +15,7 @@
 * - SOIC (Small Outline Integrated Circuit)
 * - Edge connectors
 * - Mounting holes
+* - BGA grids (panel mode, see PanelGenerator)
 *
 * Manufacturing Constants:
 * - MIN_HOLE_DIAMETER: 0.8mm
@@ -34,6 +35,8 @@
 #include <sstream>
 #include <chrono>
 #include <iomanip>
+#include <stdexcept>
+#include "distance_matrix.h"
 
 enum class BoardPattern {
     DIP_IC,        // Dual In-line Package / Integrated Circuit
@@ -41,7 +44,8 @@ enum class BoardPattern {
     CONNECTOR,     // Edge connector
     MOUNTING,      // Mounting holes
     VIA,           // Through-hole vias
-    CUSTOM         // Custom pattern
+    CUSTOM,        // Custom pattern
+    BGA            // Ball Grid Array
 };
 
 class TSPGenerator {
@@ -110,6 +114,24 @@ public:
         int num_components = 5,
         unsigned seed = 0) {
 
+        std::vector<Point> hole_positions = generateHoles(
+            board_width, board_height, num_components, seed);
+        last_generated_points = hole_positions;
+
+        return computeDistances(hole_positions);
+    }
+
+    // Hole layout only. Touches no shared state, so batch workers can call it
+    // concurrently; the same non-zero seed always yields the same board.
+    // `placed` (optional) receives the type of every component placed,
+    // mounting holes excluded.
+    static std::vector<Point> generateHoles(
+        double board_width,
+        double board_height,
+        int num_components,
+        unsigned seed,
+        std::vector<BoardPattern>* placed = nullptr) {
+
         std::mt19937 rng(seed ? seed : std::random_device{}());
         std::vector<Point> hole_positions;
         std::string board_info;
@@ -171,26 +193,25 @@ public:
                     ));
                 }
                 successful_placements++;
+                if (placed) placed->push_back(pattern.type);
                 board_info += "Added " + pattern.description + " at (" +
                     std::to_string(offset.x) + "," + std::to_string(offset.y) + ")\n";
             }
         }
 
-        // Generate distance matrix with manufacturing precision
-        int N = hole_positions.size();
-        std::vector<std::vector<double>> costs(N, std::vector<double>(N));
-
-        for (int i = 0; i < N; i++) {
-            for (int j = 0; j < N; j++) {
-                if (i != j) {
-                    costs[i][j] = hole_positions[i].distance(hole_positions[j]);
-                }
-            }
-        }
+        return hole_positions;
+    }
 
-        last_generated_points = hole_positions;
+    // Generate distance matrix with manufacturing precision (full rows in parallel, see distance_matrix.h)
+    static std::vector<std::vector<double>> computeDistances(const std::vector<Point>& hole_positions,
+        unsigned threads = 0) {
+        return DistanceMatrix::build(hole_positions, threads);
+    }
 
-        return costs;
+    // Integer distance matrix in ticks of tick_mm (e.g. 0.001 = micrometres)
+    static std::vector<std::vector<int32_t>> computeIntegerDistances(
+        const std::vector<Point>& hole_positions, double tick_mm, unsigned threads = 0) {
+        return DistanceMatrix::buildInteger(hole_positions, tick_mm, threads);
     }
 
 
@@ -225,9 +246,13 @@ public:
         int N = costs.size();
         out << N << "\n";
 
-        // Optional metadata
+        // Optional metadata, one comment line per metadata line
         if (!metadata.empty()) {
-            out << "# " << metadata << "\n";
+            std::istringstream lines(metadata);
+            std::string line;
+            while (std::getline(lines, line)) {
+                out << "# " << line << "\n";
+            }
         }
 
         for (int i = 0; i < N; i++) {
@@ -246,6 +271,14 @@ public:
         int N;
         in >> N;
 
+        // Skip metadata comment lines written by saveToFile
+        in >> std::ws;
+        while (in.peek() == '#') {
+            std::string comment;
+            std::getline(in, comment);
+            in >> std::ws;
+        }
+
         std::vector<std::vector<double>> costs(N, std::vector<double>(N));
         for (int i = 0; i < N; i++) {
             for (int j = 0; j < N; j++) {
@@ -0,0 +1,77 @@
+/**
+* @file instance_features.h
+* @brief Board descriptors used to match instances with calibrated parameters
+*
+* A board is summarized by its hole count, its hole density and the share of
+* each component type placed by TSPGenerator (DIP, SOIC, connector; the
+* four mounting holes are always present and carry no information).
+* distance() compares two boards on a common scale: size and density by
+* log ratio, so 20 vs 40 holes counts like 40 vs 80, and the component mix
+* by L1 distance in [0, 2].
+*/
+
+#ifndef INSTANCE_FEATURES_H
+#define INSTANCE_FEATURES_H
+
+#include <vector>
+#include <cmath>
+#include "data_generator.h"
+
+struct InstanceFeatures {
+    double holes;
+    double density;          // holes per cm^2 of board
+    double dip_share;
+    double soic_share;
+    double connector_share;
+
+    InstanceFeatures() : holes(0.0), density(0.0), dip_share(0.0), soic_share(0.0), connector_share(0.0) {}
+
+    static InstanceFeatures fromBoard(double board_width, double board_height, std::size_t holes,
+        const std::vector<BoardPattern>& placed) {
+        InstanceFeatures f;
+        f.holes = static_cast<double>(holes);
+        double area_cm2 = board_width * board_height / 100.0;
+        f.density = area_cm2 > 0.0 ? f.holes / area_cm2 : 0.0;
+        for (BoardPattern type : placed) {
+            if (type == BoardPattern::DIP_IC) f.dip_share += 1.0;
+            else if (type == BoardPattern::SOIC) f.soic_share += 1.0;
+            else if (type == BoardPattern::CONNECTOR) f.connector_share += 1.0;
+        }
+        if (!placed.empty()) {
+            f.dip_share /= placed.size();
+            f.soic_share /= placed.size();
+            f.connector_share /= placed.size();
+        }
+        return f;
+    }
+
+    static InstanceFeatures mean(const std::vector<InstanceFeatures>& all) {
+        InstanceFeatures m;
+        if (all.empty()) return m;
+        for (const auto& f : all) {
+            m.holes += f.holes;
+            m.density += f.density;
+            m.dip_share += f.dip_share;
+            m.soic_share += f.soic_share;
+            m.connector_share += f.connector_share;
+        }
+        double k = static_cast<double>(all.size());
+        m.holes /= k;
+        m.density /= k;
+        m.dip_share /= k;
+        m.soic_share /= k;
+        m.connector_share /= k;
+        return m;
+    }
+
+    double distance(const InstanceFeatures& other) const {
+        auto logRatio = [](double a, double b) {
+            return std::abs(std::log((a + 1e-9) / (b + 1e-9)));
+        };
+        return logRatio(holes, other.holes) + logRatio(density, other.density) +
+            std::abs(dip_share - other.dip_share) + std::abs(soic_share - other.soic_share) +
+            std::abs(connector_share - other.connector_share);
+    }
+};
+
+#endif /* INSTANCE_FEATURES_H */
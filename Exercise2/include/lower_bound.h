@@ -0,0 +1,55 @@
+/**
+* @file lower_bound.h
+* @brief Held-Karp 1-tree lower bound with subgradient optimization
+*
+* Gives a CPLEX-free optimality gauge for tabu search results in a few
+* milliseconds:
+* - 1-tree: minimum spanning tree over nodes 1..n-1 (dense Prim, O(n^2))
+*   plus the two cheapest edges at node 0; every tour is a 1-tree
+* - Lagrangian node penalties pi_i enforce degree 2:
+*     L(pi) = w(1-tree under c_ij + pi_i + pi_j) - 2 * sum(pi)
+*   maximized by subgradient steps along (degree_i - 2) with the
+*   Held-Wolfe-Crowder step t = lambda * (UB - L) / |g|^2
+*
+* Works on the symmetric costs min(c_ij, c_ji), which is still a valid bound
+* for asymmetric instances. In integer mode the bound is rounded up, as
+* every tour has an integral value. Values are in solver units, like
+* TSPSolver::evaluate(); use TSP::toLength() to convert.
+*/
+
+#ifndef LOWER_BOUND_H
+#define LOWER_BOUND_H
+
+#include <vector>
+#include "TSP.h"
+
+class HeldKarpBound {
+public:
+    struct Result {
+        double bound;               // best L(pi) found
+        int iterations;
+        bool optimal;               // the best 1-tree was a tour: bound is the optimum
+        double time_ms;
+        std::vector<double> penalties;
+    };
+
+    explicit HeldKarpBound(int max_iterations = 1000) : max_iterations(max_iterations) {}
+
+    // upper_bound <= 0: a nearest-neighbour tour supplies the step target
+    Result compute(const TSP& tsp, double upper_bound = 0.0) const;
+
+    // Optimality gap in percent of a tour value against a bound
+    static double gap(double tour_value, double bound) {
+        return tour_value > 0.0 ? (tour_value - bound) / tour_value * 100.0 : 0.0;
+    }
+
+private:
+    int max_iterations;
+
+    // Weight of the 1-tree under penalties; fills the node degrees
+    static double oneTree(const std::vector<double>& cost, int n,
+        const std::vector<double>& pi, std::vector<int>& degree);
+    static double nearestNeighbour(const std::vector<double>& cost, int n);
+};
+
+#endif /* LOWER_BOUND_H */
@@ -0,0 +1,372 @@
+/**
+* @file panel_generator.h
+* @brief Production-scale panel generator (5k-100k holes)
+*
+* Extends the single-board TSPGenerator with a mode that produces realistic
+* manufacturing panels:
+* - A board layout is generated once and stepped-and-repeated over a
+*   boards_x x boards_y panel, with tooling holes on the panel rails
+* - Board content mixes BGA grids, via fields, dense connector rows and the
+*   standard DIP/SOIC packages
+* - Spacing checks use a uniform hash grid (cell = MIN_HOLE_SPACING), so each
+*   candidate hole only inspects a constant number of neighbours and
+*   placement runs in O(n) expected time instead of O(n^2)
+*
+* Only hole positions are produced; at these sizes a dense distance matrix
+* (n^2 doubles) is usually too large, so callers decide how to derive costs.
+* saveHoles()/loadHoles() store them as text: the hole count, optional
+* "# " metadata lines, then one "x y" line per hole (mm).
+*/
+
+#ifndef PANEL_GENERATOR_H
+#define PANEL_GENERATOR_H
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <array>
+#include <algorithm>
+#include <stdexcept>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include "data_generator.h"
+
+class PanelGenerator {
+public:
+    using Point = TSPGenerator::Point;
+    using Component = TSPGenerator::Component;
+
+    static constexpr int NUM_BOARD_PATTERNS = static_cast<int>(BoardPattern::BGA) + 1;
+
+    struct PanelSpec {
+        int boards_x;              // boards per panel row
+        int boards_y;              // boards per panel column
+        double board_width;        // mm
+        double board_height;       // mm
+        double board_gap;          // routing gap between boards (mm)
+        double rail_width;         // tooling rail around the panel (mm)
+        int holes_per_board;       // target drilled holes per board
+        // Relative share of holes per component family
+        double bga_share;
+        double via_share;
+        double connector_share;
+        double package_share;      // DIP/SOIC
+
+        PanelSpec() :
+            boards_x(2), boards_y(2), board_width(100), board_height(80),
+            board_gap(4.0), rail_width(10.0), holes_per_board(1250),
+            bga_share(0.35), via_share(0.35), connector_share(0.15), package_share(0.15) {}
+    };
+
+    struct Panel {
+        std::vector<Point> holes;
+        double width;
+        double height;
+        // Placed components per BoardPattern (indexed by the enum value), whole panel
+        std::array<int, NUM_BOARD_PATTERNS> component_counts;
+    };
+
+    // Typical drilled density of a populated board, used to size panels
+    static constexpr double HOLES_PER_MM2 = 0.08;
+
+    /**
+    * Spec whose step-and-repeat panel reaches roughly total_holes holes.
+    * Boards are sized from HOLES_PER_MM2; large counts are split over more
+    * boards rather than growing a single board without bound.
+    */
+    static PanelSpec specForHoleCount(int total_holes) {
+        PanelSpec spec;
+        int boards = total_holes <= 2000 ? 1 : total_holes <= 20000 ? 4 : 16;
+        spec.boards_x = boards == 1 ? 1 : boards == 4 ? 2 : 4;
+        spec.boards_y = spec.boards_x;
+        spec.holes_per_board = std::max(1, total_holes / boards);
+
+        double area = spec.holes_per_board / HOLES_PER_MM2;
+        spec.board_width = std::max(40.0, std::sqrt(area * 1.25));
+        spec.board_height = std::max(32.0, area / spec.board_width);
+        return spec;
+    }
+
+    static Panel generate(const PanelSpec& spec, unsigned seed = 0) {
+        if (spec.boards_x < 1 || spec.boards_y < 1 || spec.holes_per_board < 1) {
+            throw std::invalid_argument("PanelGenerator: empty panel specification");
+        }
+
+        std::mt19937 rng(seed ? seed : std::random_device{}());
+        Panel panel;
+        panel.component_counts.fill(0);
+
+        std::array<int, NUM_BOARD_PATTERNS> board_counts;
+        std::vector<Point> board = generateBoard(spec, rng, board_counts);
+
+        panel.width = 2 * spec.rail_width + spec.boards_x * spec.board_width +
+            (spec.boards_x - 1) * spec.board_gap;
+        panel.height = 2 * spec.rail_width + spec.boards_y * spec.board_height +
+            (spec.boards_y - 1) * spec.board_gap;
+
+        // Tooling holes on the rails
+        double r = spec.rail_width / 2;
+        panel.holes = { Point(r, r), Point(panel.width - r, r),
+            Point(r, panel.height - r), Point(panel.width - r, panel.height - r) };
+        panel.component_counts[static_cast<int>(BoardPattern::MOUNTING)]++;
+
+        // Step and repeat
+        panel.holes.reserve(panel.holes.size() + board.size() * spec.boards_x * spec.boards_y);
+        for (int by = 0; by < spec.boards_y; by++) {
+            for (int bx = 0; bx < spec.boards_x; bx++) {
+                double ox = spec.rail_width + bx * (spec.board_width + spec.board_gap);
+                double oy = spec.rail_width + by * (spec.board_height + spec.board_gap);
+                for (const auto& h : board) {
+                    panel.holes.push_back(Point(ox + h.x, oy + h.y));
+                }
+                for (int k = 0; k < NUM_BOARD_PATTERNS; k++) {
+                    panel.component_counts[k] += board_counts[k];
+                }
+            }
+        }
+
+        return panel;
+    }
+
+    // Full-array BGA footprint; optionally depopulated in the centre
+    static Component createBGA(int rows, int cols, double pitch, int depopulated = 0) {
+        Component c{ BoardPattern::BGA, {}, pitch * 0.9,
+            std::to_string(rows) + "x" + std::to_string(cols) + " BGA" };
+        int r0 = (rows - depopulated) / 2, c0 = (cols - depopulated) / 2;
+        for (int r = 0; r < rows; r++) {
+            for (int k = 0; k < cols; k++) {
+                bool hole_free = depopulated > 0 &&
+                    r >= r0 && r < r0 + depopulated && k >= c0 && k < c0 + depopulated;
+                if (!hole_free) c.holes.push_back(Point(k * pitch, r * pitch));
+            }
+        }
+        return c;
+    }
+
+    // rows x pins header (e.g. 2x40 at 2.54mm, 2x64 at 1.27mm)
+    static Component createConnectorRow(int pins, int rows, double pitch) {
+        Component c{ BoardPattern::CONNECTOR, {}, pitch * 0.9,
+            std::to_string(rows) + "x" + std::to_string(pins) + " connector" };
+        for (int r = 0; r < rows; r++) {
+            for (int p = 0; p < pins; p++) {
+                c.holes.push_back(Point(p * pitch, r * pitch));
+            }
+        }
+        return c;
+    }
+
+    // Jittered-grid via field: every pitch cell holds a via with probability fill
+    static Component createViaField(double width, double height, double pitch,
+        double fill, std::mt19937& rng) {
+        Component c{ BoardPattern::VIA, {}, TSPGenerator::MIN_HOLE_DIAMETER,
+            "via field" };
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        double jitter = std::max(0.0, pitch - c.min_spacing) / 2;
+        for (double y = 0; y <= height; y += pitch) {
+            for (double x = 0; x <= width; x += pitch) {
+                if (unit(rng) < fill) {
+                    c.holes.push_back(Point(x + (unit(rng) - 0.5) * jitter,
+                        y + (unit(rng) - 0.5) * jitter));
+                }
+            }
+        }
+        return c;
+    }
+
+    static void saveHoles(const std::string& filename, const std::vector<Point>& holes,
+        const std::string& metadata = "") {
+        std::ofstream out(filename);
+        if (!out) throw std::runtime_error("Cannot open file: " + filename);
+
+        out << holes.size() << "\n";
+        if (!metadata.empty()) {
+            std::istringstream lines(metadata);
+            std::string line;
+            while (std::getline(lines, line)) {
+                out << "# " << line << "\n";
+            }
+        }
+        out << std::fixed << std::setprecision(4);
+        for (const auto& h : holes) {
+            out << h.x << " " << h.y << "\n";
+        }
+        if (!out) throw std::runtime_error("Error writing file: " + filename);
+    }
+
+    static std::vector<Point> loadHoles(const std::string& filename) {
+        std::ifstream in(filename);
+        if (!in) throw std::runtime_error("Cannot open file: " + filename);
+
+        std::size_t n = 0;
+        in >> n;
+        in >> std::ws;
+        while (in.peek() == '#') {
+            std::string comment;
+            std::getline(in, comment);
+            in >> std::ws;
+        }
+
+        std::vector<Point> holes;
+        holes.reserve(n);
+        double x, y;
+        while (holes.size() < n && in >> x >> y) {
+            holes.push_back(Point(x, y));
+        }
+        if (holes.size() != n) throw std::runtime_error("Truncated hole file: " + filename);
+        return holes;
+    }
+
+private:
+    using EM = TSPGenerator;
+
+    /**
+    * Uniform hash grid over the board. Cell size equals MIN_HOLE_SPACING, so a
+    * spacing query of radius s inspects (2*ceil(s/cell)+1)^2 cells, each holding
+    * O(1) holes thanks to the spacing rule itself.
+    */
+    class SpacingGrid {
+    public:
+        SpacingGrid(double width, double height, double cell)
+            : cell(cell),
+              cols(static_cast<int>(width / cell) + 1),
+              rows(static_cast<int>(height / cell) + 1),
+              head(static_cast<std::size_t>(cols) * rows, -1) {}
+
+        bool isFree(const Point& p, double spacing, const std::vector<Point>& holes) const {
+            int reach = static_cast<int>(std::ceil(spacing / cell));
+            int cx = cellX(p.x), cy = cellY(p.y);
+            double s2 = spacing * spacing;
+            for (int y = std::max(0, cy - reach); y <= std::min(rows - 1, cy + reach); y++) {
+                for (int x = std::max(0, cx - reach); x <= std::min(cols - 1, cx + reach); x++) {
+                    for (int h = head[y * cols + x]; h >= 0; h = next[h]) {
+                        double dx = holes[h].x - p.x, dy = holes[h].y - p.y;
+                        if (dx * dx + dy * dy < s2) return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        void insert(const Point& p, int index) {
+            int c = cellY(p.y) * cols + cellX(p.x);
+            if (static_cast<int>(next.size()) <= index) next.resize(index + 1, -1);
+            next[index] = head[c];
+            head[c] = index;
+        }
+
+    private:
+        double cell;
+        int cols, rows;
+        std::vector<int> head;  // first hole per cell
+        std::vector<int> next;  // intrusive per-cell lists
+
+        int cellX(double x) const { return std::min(cols - 1, std::max(0, static_cast<int>(x / cell))); }
+        int cellY(double y) const { return std::min(rows - 1, std::max(0, static_cast<int>(y / cell))); }
+    };
+
+    static std::vector<Point> generateBoard(const PanelSpec& spec, std::mt19937& rng,
+        std::array<int, NUM_BOARD_PATTERNS>& counts) {
+
+        const double W = spec.board_width, H = spec.board_height;
+        counts.fill(0);
+
+        std::vector<Point> holes;
+        holes.reserve(spec.holes_per_board + 256);
+        SpacingGrid grid(W, H, EM::MIN_HOLE_SPACING);
+
+        auto standard = EM::createStandardPatterns(W, H);
+        for (const auto& h : standard[3].holes) {  // mounting holes
+            grid.insert(h, static_cast<int>(holes.size()));
+            holes.push_back(h);
+        }
+        counts[static_cast<int>(BoardPattern::MOUNTING)]++;
+
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+        std::uniform_int_distribution<int> pick(0, 1 << 20);
+        double shares[4] = { spec.bga_share, spec.via_share, spec.connector_share, spec.package_share };
+        std::discrete_distribution<int> family(shares, shares + 4);
+
+        // Stop once the target is met or the board is saturated
+        const int max_consecutive_failures = 200;
+        int failures = 0;
+        while (static_cast<int>(holes.size()) < spec.holes_per_board &&
+            failures < max_consecutive_failures) {
+
+            Component c;
+            switch (family(rng)) {
+            case 0: {
+                int size = 6 + pick(rng) % 19;  // 6x6 .. 24x24
+                double pitch = (pick(rng) % 2) ? 1.0 : 1.27;
+                c = createBGA(size, size, pitch, size >= 12 ? size / 3 : 0);
+                break;
+            }
+            case 1: {
+                double fw = 5.0 + unit(rng) * 15.0, fh = 5.0 + unit(rng) * 15.0;
+                c = createViaField(fw, fh, 1.5, 0.6, rng);
+                break;
+            }
+            case 2: {
+                int pins = 20 + pick(rng) % 45;  // 20 .. 64 pins
+                double pitch = (pick(rng) % 2) ? 2.54 : 1.27;
+                c = createConnectorRow(pins, 2, pitch);
+                break;
+            }
+            default:
+                c = standard[pick(rng) % 2];  // DIP-14 or SOIC-8
+                break;
+            }
+
+            if (c.holes.empty() || !tryPlace(c, W, H, rng, grid, holes)) {
+                failures++;
+                continue;
+            }
+            failures = 0;
+            counts[static_cast<int>(c.type)]++;
+        }
+
+        return holes;
+    }
+
+    static bool tryPlace(const Component& c, double W, double H, std::mt19937& rng,
+        SpacingGrid& grid, std::vector<Point>& holes) {
+
+        double minX = c.holes[0].x, minY = c.holes[0].y, maxX = minX, maxY = minY;
+        for (const auto& h : c.holes) {
+            minX = std::min(minX, h.x);
+            minY = std::min(minY, h.y);
+            maxX = std::max(maxX, h.x);
+            maxY = std::max(maxY, h.y);
+        }
+        double spanX = W - 2 * EM::EDGE_MARGIN - (maxX - minX);
+        double spanY = H - 2 * EM::EDGE_MARGIN - (maxY - minY);
+        if (spanX < 0 || spanY < 0) return false;
+
+        // Offsets keep the whole footprint inside the edge clearance
+        std::uniform_real_distribution<double> x_dist(EM::EDGE_MARGIN - minX, EM::EDGE_MARGIN - minX + spanX);
+        std::uniform_real_distribution<double> y_dist(EM::EDGE_MARGIN - minY, EM::EDGE_MARGIN - minY + spanY);
+
+        for (int attempt = 0; attempt < 10; attempt++) {
+            Point offset(x_dist(rng), y_dist(rng));
+            bool valid = true;
+            for (const auto& h : c.holes) {
+                if (!grid.isFree(Point(offset.x + h.x, offset.y + h.y), c.min_spacing, holes)) {
+                    valid = false;
+                    break;
+                }
+            }
+            if (!valid) continue;
+
+            for (const auto& h : c.holes) {
+                Point p(offset.x + h.x, offset.y + h.y);
+                grid.insert(p, static_cast<int>(holes.size()));
+                holes.push_back(p);
+            }
+            return true;
+        }
+        return false;
+    }
+};
+
+#endif /* PANEL_GENERATOR_H */
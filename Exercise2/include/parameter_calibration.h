@@ -11,6 +11,42 @@
 * - Tests multiple tenure/iteration combinations
 * - Statistical analysis of solution quality
 * - Automated quality/runtime tradeoff evaluation
+*
+* The grid runs on a ThreadPool with one task per (combination, instance).
+* Training boards and solver seeds are fixed by the calibration seed, and
+* results are folded in submission order. Every decision uses gaps and
+* iteration counts, never measured time, so the chosen parameters do not
+* depend on the number of threads; only the printed timings do.
+*
+* raceParameters() is the cheaper alternative (F-Race, Birattari et al.
+* 2002). Candidates are sampled from continuous ranges of all reactive
+* knobs and evaluated one training instance at a time. Once a few
+* instances are in, a Friedman test on the per-instance ranks checks
+* whether the candidates differ. If they do, every candidate whose rank sum
+* is significantly worse than the best (Conover post-hoc test) is dropped.
+* Candidates are ranked by gap, and gaps within gap_resolution of each
+* other are ranked by the iterations the search ran: on small boards most
+* settings reach the same tour, and a race on gap alone would tie and never
+* drop anything. Iterations, unlike measured time, do not depend on what
+* else the pool is running, so a race with a fixed seed is reproducible.
+* The race streams up to RaceSettings::instances boards per class, so
+* dominated settings stop consuming runs while the survivors see far more
+* boards than the grid. When halving_interval boards pass without the test
+* dropping anyone, the candidates in the worse half by rank sum are dropped
+* (successive halving), which ends races between near-equal settings.
+*
+* Both calibrate each size class (<= 20, <= 35, > 35 holes) on its own
+* training boards. The boards are built with the CostModel and cost mode
+* (real or integer ticks) the parameters will be used with, since the
+* move landscape differs between metrics. Quality is the gap in percent to
+* the instance's Held-Karp 1-tree bound, so boards of different size
+* weigh the same. Cost is the mean number of iterations run, a reproducible
+* stand-in for time since every iteration is one O(n^2) neighbourhood scan.
+* A class keeps the configurations on its quality/cost Pareto front and
+* picks the cheapest one within gap_tolerance percentage points of the
+* best gap. Given a ParameterStore, each class is also
+* recorded with the mean features of its training boards, so later runs
+* can skip calibration (see parameter_store.h).
 */
 
 #ifndef PARAMETER_CALIBRATION_H
@@ -18,44 +54,184 @@
 
 #include <vector>
 #include <tuple>
+#include <string>
 #include "TSP.h"
+#include "cost_model.h"
+#include "instance_features.h"
+
+class TSPSolver;
+class ParameterStore;
 
 class ParameterCalibration {
 public:
+    enum SizeClass { SMALL = 0, MEDIUM = 1, LARGE = 2, SIZE_CLASSES = 3 };
+
+    // threads == 0 uses every hardware thread; integer_costs trains on
+    // cost_model.integerTick() ticks, as main's --integer-costs
+    explicit ParameterCalibration(unsigned threads = 0, const CostModel& cost_model = CostModel(),
+        bool integer_costs = false, unsigned seed = 2024, double gap_tolerance = 0.5)
+        : threads(threads), cost_model(cost_model), integer_costs(integer_costs),
+          seed(seed), gap_tolerance(gap_tolerance) {}
+
+    static SizeClass sizeClass(int n) { return n <= 20 ? SMALL : n <= 35 ? MEDIUM : LARGE; }
+    static const char* className(SizeClass cls);
+
+    // Tabu settings of one size class (TSPSolver defaults)
+    struct ClassParameters {
+        int tenure;
+        int iterations;
+        int min_tenure;
+        int max_tenure;
+        int max_iterations_without_improvement;
+        int intensification_iterations;
+
+        ClassParameters(int t = 7, int i = 1000) :
+            tenure(t), iterations(i), min_tenure(5), max_tenure(20),
+            max_iterations_without_improvement(100), intensification_iterations(50) {}
+
+        void applyTo(TSPSolver& solver) const;
+    };
+
     struct Parameters {
-        int small_tenure;
-        int medium_tenure;
-        int large_tenure;
-        int small_iterations;
-        int medium_iterations;
-        int large_iterations;
+        ClassParameters classes[SIZE_CLASSES];
+
+        Parameters() : classes{ ClassParameters(5, 100), ClassParameters(7, 200), ClassParameters(9, 300) } {}
 
-        Parameters() :
-            small_tenure(5), medium_tenure(7), large_tenure(9),
-            small_iterations(100), medium_iterations(200), large_iterations(300) {}
+        const ClassParameters& forSize(int n) const { return classes[sizeClass(n)]; }
+        // Configures a solver for an instance of n holes
+        void applyTo(TSPSolver& solver, int n) const;
     };
 
     struct CalibrationResult {
         int tenure;
         int iterations;
-        double avg_solution_quality;
+        double avg_solution_quality;   // gap to the 1-tree bound, percent
         double avg_time_ms;
         double std_dev_quality;
+        double avg_iterations;         // iterations run, the cost axis of the front
+
+        CalibrationResult(int t = 0, int i = 0, double q = 0.0, double time = 0.0, double dev = 0.0,
+            double iters = 0.0)
+            : tenure(t), iterations(i), avg_solution_quality(q), avg_time_ms(time), std_dev_quality(dev),
+              avg_iterations(iters) {}
+    };
+
+    // One point of the search space
+    struct Configuration {
+        int tenure;
+        int iteration_multiplier;   // iterations = multiplier * n
+        int min_tenure;
+        int max_tenure;
+        int max_iterations_without_improvement;
+        int intensification_iterations;
 
-        CalibrationResult(int t = 0, int i = 0, double q = 0.0, double time = 0.0, double dev = 0.0)
-            : tenure(t), iterations(i), avg_solution_quality(q), avg_time_ms(time), std_dev_quality(dev) {}
+        Configuration(int t = 7, int m = 10) :
+            tenure(t), iteration_multiplier(m), min_tenure(5), max_tenure(20),
+            max_iterations_without_improvement(100), intensification_iterations(50) {}
     };
 
-    Parameters calibrateParameters(const std::vector<std::tuple<int, int, int>>& board_configs);
+    // Inclusive sampling range for one knob
+    struct Range {
+        int lo;
+        int hi;
+    };
+
+    struct RaceSettings {
+        Range tenure;
+        Range iteration_multiplier;
+        Range min_tenure;
+        Range max_tenure;
+        Range max_iterations_without_improvement;
+        Range intensification_iterations;
+        int candidates;        // sampled configurations
+        int instances;         // training boards per class, at most
+        int min_instances;     // instances seen before the first test
+        int halving_interval;  // boards without an elimination before halving
+        double alpha;          // significance level
+        double gap_resolution; // gaps closer than this (percentage points) tie
+
+        RaceSettings() :
+            tenure{ 5, 13 }, iteration_multiplier{ 10, 30 },
+            min_tenure{ 2, 8 }, max_tenure{ 10, 30 },
+            max_iterations_without_improvement{ 30, 300 }, intensification_iterations{ 10, 100 },
+            candidates(24), instances(40), min_instances(5), halving_interval(5),
+            alpha(0.05), gap_resolution(0.1) {}
+    };
+
+    // With a store, every calibrated class is added as an entry
+    Parameters calibrateParameters(const std::vector<std::tuple<int, int, int>>& board_configs,
+        ParameterStore* store = nullptr);
+    Parameters raceParameters(const std::vector<std::tuple<int, int, int>>& board_configs,
+        const RaceSettings& settings = RaceSettings(), ParameterStore* store = nullptr);
 
 private:
+    static constexpr int INSTANCES_PER_CLASS = 10;      // grid calibration
+    static constexpr int BOARDS_PER_INSTANCE = 30;      // generation budget per requested board
+
+    unsigned threads;
+    CostModel cost_model;
+    bool integer_costs;
+    unsigned seed;
+    double gap_tolerance;
+
     const std::vector<int> tenure_values = { 5, 7, 9, 11, 13 };
     const std::vector<int> iteration_multipliers = { 10, 15, 20, 25, 30 };
 
-    CalibrationResult testParameterCombination(
-        const std::vector<TSP>& instances,
-        int tenure,
-        int iteration_multiplier);
+    // Training board with its 1-tree bound (solver units)
+    struct TrainingInstance {
+        TSP tsp;
+        InstanceFeatures features;
+        double reference;
+        unsigned solver_seed;
+    };
+
+    // Outcome of one tabu search run on one training instance
+    struct RunResult {
+        bool solved;
+        double quality;     // gap to the reference, percent
+        double time_ms;
+        int iterations;     // iterations the search ran
+    };
+
+    std::vector<std::vector<TrainingInstance>> generateTrainingSets(
+        const std::vector<std::tuple<int, int, int>>& board_configs, int per_class) const;
+
+    RunResult runInstance(const TrainingInstance& instance, const Configuration& config) const;
+    CalibrationResult summarize(const std::vector<RunResult>& runs,
+        int tenure, int iterations) const;
+
+    // Non-dominated results (lower gap, fewer iterations) and the pick among them
+    static std::vector<std::size_t> paretoFront(const std::vector<CalibrationResult>& results);
+    std::size_t selectFromFront(const std::vector<CalibrationResult>& results,
+        const std::vector<std::size_t>& front) const;
+
+    ClassParameters toClassParameters(const Configuration& config, double mean_n) const;
+    static void record(ParameterStore* store, SizeClass cls,
+        const std::vector<TrainingInstance>& set, const ClassParameters& params);
+
+    std::vector<Configuration> sampleConfigurations(const RaceSettings& settings) const;
+    // Race score of one run: quantized gap first, iterations on ties
+    struct RaceScore {
+        double gap_level;
+        int iterations;
+        bool operator<(const RaceScore& o) const {
+            return gap_level < o.gap_level || (gap_level == o.gap_level && iterations < o.iterations);
+        }
+        bool operator==(const RaceScore& o) const {
+            return gap_level == o.gap_level && iterations == o.iterations;
+        }
+    };
+
+    // Per-candidate rank sums over the instances (ties share their average
+    // rank); returns the sum of all squared ranks
+    static double rankSums(const std::vector<std::vector<RaceScore>>& scores,
+        std::vector<double>& rank_sum);
+    // Indices (into alive) of the candidates that survive the Friedman test;
+    // scores[b][c] is the result of alive candidate c on instance b
+    static std::vector<std::size_t> friedmanSurvivors(
+        const std::vector<std::vector<RaceScore>>& scores, double alpha);
+    // Indices of the better half (rounded up) by rank sum
+    static std::vector<std::size_t> betterHalf(const std::vector<std::vector<RaceScore>>& scores);
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,72 @@
+/**
+* @file parameter_store.h
+* @brief Persistent, versioned store of calibrated tabu search parameters
+*
+* Calibration is expensive. Its outcome is therefore kept on disk as a list of
+* (instance features, ClassParameters) entries, one per calibrated size
+* class, and reused by later runs. At solve time lookup() returns the
+* parameters of the entry nearest to the board's features, with the
+* iteration budget scaled to the board's hole count.
+*
+* Parameters calibrated under one cost model (and cost mode, real or
+* integer ticks) do not carry over to another, so a store is bound to the
+* pair it was constructed with and records it in its header.
+*
+* File format (plain text):
+*   # tsp-parameter-store <FORMAT_VERSION> <cost model> <real|integer>
+*   <label> <holes> <density> <dip> <soic> <connector> <tenure> <iterations>
+*           <min_tenure> <max_tenure> <stagnation> <intensification>
+* A file with another version or cost model, or one that does not parse, is
+* rejected by load(), so stale stores trigger a fresh calibration.
+*/
+
+#ifndef PARAMETER_STORE_H
+#define PARAMETER_STORE_H
+
+#include <vector>
+#include <string>
+#include "instance_features.h"
+#include "parameter_calibration.h"
+
+class ParameterStore {
+public:
+    static constexpr int FORMAT_VERSION = 2;
+
+    struct Entry {
+        std::string label;      // no whitespace
+        InstanceFeatures features;
+        ParameterCalibration::ClassParameters params;
+    };
+
+    explicit ParameterStore(const std::string& path, const CostModel& cost_model = CostModel(),
+        bool integer_costs = false)
+        : path(path), cost_model(cost_model.name()), integer_costs(integer_costs) {}
+
+    // False if the file is missing, malformed, of another version or of
+    // another cost model or mode; the store is left unchanged then
+    bool load();
+    void save() const;
+
+    // Replaces an entry with the same label
+    void add(const Entry& entry);
+    void clear() { entries.clear(); }
+
+    bool empty() const { return entries.empty(); }
+    const std::vector<Entry>& getEntries() const { return entries; }
+    const std::string& getPath() const { return path; }
+    // "<cost model> <real|integer>", as in the header
+    std::string costing() const { return cost_model + (integer_costs ? " integer" : " real"); }
+
+    // Nearest entry by InstanceFeatures::distance, nullptr when empty
+    const Entry* nearest(const InstanceFeatures& features) const;
+    // Parameters of the nearest entry, iterations scaled to features.holes
+    ParameterCalibration::ClassParameters lookup(const InstanceFeatures& features) const;
+
+private:
+    std::string path;
+    std::string cost_model;
+    bool integer_costs;
+    std::vector<Entry> entries;
+};
+
+#endif /* PARAMETER_STORE_H */
@@ -0,0 +1,62 @@
+/**
+* @file raster_renderer.h
+* @brief Dependency-free raster frames of drilling tours (PNG/PPM)
+*
+* Meant for animations of long runs replayed from a SearchTrace, where an
+* SVG per frame is far too heavy. Frames are 8-bit palette images:
+* - the board mapping is computed once per renderer, like BoardVisualizer
+* - tour edges are Bresenham lines, colored from blue to red in
+*   GRADIENT_BANDS bands along the visiting order; holes are small squares
+* - writePNG() emits an indexed PNG whose zlib stream uses stored (raw)
+*   deflate blocks, so encoding is a copy plus CRC-32 and Adler-32;
+*   writePPM() emits binary RGB
+* Both encoders build the file in memory and write it once. Rendering and
+* encoding reuse the renderer's buffers, so a renderer is not thread-safe;
+* use one per thread.
+*/
+
+#ifndef RASTER_RENDERER_H
+#define RASTER_RENDERER_H
+
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstdint>
+
+class RasterRenderer {
+public:
+    static constexpr int GRADIENT_BANDS = 16;
+
+    // width in pixels; the longer board side spans it (as in
+    // BoardVisualizer::calculateScaling), so the height is at most width
+    RasterRenderer(const std::vector<std::pair<double, double>>& points, int width = 800,
+        int margin = 10, int hole_radius = 1);
+
+    // Draws the tour (sequence of point indices) over the holes
+    void render(const std::vector<int>& tour);
+
+    // Throw std::runtime_error if the file cannot be written
+    void writePNG(const std::string& filename);
+    void writePPM(const std::string& filename);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::vector<uint8_t>& getPixels() const { return pixels; }  // palette indices
+
+private:
+    enum Color : uint8_t { BACKGROUND = 0, HOLE = 1, FIRST_BAND = 2 };
+
+    int width;
+    int height;
+    int hole_radius;
+    std::vector<std::pair<int, int>> pixel_points;
+    std::vector<uint8_t> pixels;
+    std::vector<uint8_t> palette;   // RGB triples
+    std::vector<uint8_t> encoded;
+
+    void drawLine(int x0, int y0, int x1, int y1, uint8_t color);
+    void drawHole(int x, int y);
+    static void writeFile(const std::string& filename, const std::vector<uint8_t>& data);
+};
+
+#endif /* RASTER_RENDERER_H */
@@ -0,0 +1,131 @@
+/**
+* @file search_trace.h
+* @brief Fixed-size binary trace of a tabu search run
+*
+* The solver appends one 24-byte Record per iteration to a preallocated ring
+* buffer, so a run of any length keeps its last `capacity` iterations without
+* allocating in the search loop. A Record holds the iteration, the elapsed
+* time, the tour length after the iteration, the 2-opt move (segment
+* positions, 32 bits so panel-sized tours fit), the tenure and what the
+* iteration did.
+*
+* Tours are not stored per iteration. A keyframe (full sequence) is taken
+* every keyframe_interval iterations and whenever intensification or
+* diversification rewrote the tour; any other iteration is the previous one
+* plus its 2-opt move. A base tour, the state just before the oldest
+* buffered record, rolls forward as records are overwritten, so tourAt()
+* can replay every iteration still in the ring from the base or the nearest
+* keyframe. Keyframe buffers are recycled once their record is gone.
+*
+* flush() writes a binary file (native byte order):
+*   "TSPTRACE" | u32 version | u32 record size | u32 board points
+*   | u32 sequence length | u32 records | u32 keyframes | u64 dropped records
+*   | points (2 x f64 each) | base (i32 sequence) | records
+*   | keyframes (u32 iteration + i32 sequence)
+* load() reads it back; tools/trace_replay.cpp is the analysis front end.
+*/
+
+#ifndef SEARCH_TRACE_H
+#define SEARCH_TRACE_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <cstdint>
+
+class SearchTrace {
+public:
+    static constexpr uint32_t FORMAT_VERSION = 2;
+
+    enum Flags : uint8_t {
+        IMPROVED = 1,        // new best tour
+        INTENSIFIED = 2,
+        DIVERSIFIED = 4,
+        KEYFRAME = 8         // the tour after this iteration is stored in full
+    };
+
+    struct Record {
+        uint32_t iteration;
+        uint32_t elapsed_us;    // since the search started
+        float cost;             // tour length after the iteration (mm or s)
+        uint32_t move_from;     // reversed segment [move_from, move_to]
+        uint32_t move_to;
+        uint8_t tenure;
+        uint8_t flags;
+        uint16_t reserved;
+    };
+    static_assert(sizeof(Record) == 24, "trace records are 24 bytes on disk");
+
+    struct Keyframe {
+        uint32_t iteration;
+        std::vector<int> sequence;
+    };
+
+    explicit SearchTrace(std::size_t capacity = 1 << 16, int keyframe_interval = 256);
+
+    // Board coordinates, stored in the file so tours can be re-rendered
+    void setPoints(const std::vector<std::pair<double, double>>& board_points) { points = board_points; }
+
+    // Starts a run from the initial tour; keeps the buffers for the next one
+    void begin(const std::vector<int>& initial);
+    // Hot path: one call per completed iteration
+    void record(uint32_t iteration, uint32_t elapsed_us, double cost, int move_from, int move_to,
+        int tenure, uint8_t flags, const std::vector<int>& sequence);
+
+    // Writes the buffered run; throws std::runtime_error on I/O failure
+    void flush(const std::string& path) const;
+    // False if the file is missing, truncated or of another version
+    bool load(const std::string& path);
+
+    // Records in iteration order (oldest first)
+    std::vector<Record> getRecords() const;
+    const std::vector<std::pair<double, double>>& getPoints() const { return points; }
+    uint64_t getDropped() const { return dropped; }
+
+    // Tour after the given iteration; false if it is no longer in the buffer
+    bool tourAt(uint32_t iteration, std::vector<int>& sequence) const;
+    // Calls visit(record, tour after it) for every buffered iteration in
+    // order, applying one move per step instead of a tourAt() per iteration
+    template <typename Visitor>
+    void replay(Visitor&& visit) const;
+
+private:
+    std::size_t capacity;
+    int keyframe_interval;
+    std::size_t sequence_length;
+    std::vector<std::pair<double, double>> points;
+
+    std::vector<Record> ring;
+    std::size_t head;       // next slot to write
+    std::size_t count;
+    uint64_t dropped;       // records overwritten since begin()
+
+    // Tour before the oldest buffered record
+    std::vector<int> base;
+    // Keyframes of buffered records, oldest first
+    std::deque<Keyframe> keyframes;
+    std::vector<std::vector<int>> spare_sequences;
+
+    const Record& at(std::size_t i) const { return ring[(head + capacity - count + i) % capacity]; }
+};
+
+template <typename Visitor>
+void SearchTrace::replay(Visitor&& visit) const {
+    std::vector<int> sequence = base;
+    auto keyframe = keyframes.begin();
+    for (std::size_t i = 0; i < count; i++) {
+        const Record& r = at(i);
+        if (keyframe != keyframes.end() && keyframe->iteration == r.iteration) {
+            sequence = keyframe->sequence;
+            ++keyframe;
+        }
+        else if (r.move_to < sequence.size()) {
+            std::reverse(sequence.begin() + r.move_from, sequence.begin() + r.move_to + 1);
+        }
+        visit(r, static_cast<const std::vector<int>&>(sequence));
+    }
+}
+
+#endif /* SEARCH_TRACE_H */
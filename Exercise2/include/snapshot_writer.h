@@ -0,0 +1,138 @@
+/**
+* @file snapshot_writer.h
+* @brief Background SVG writer for tabu search snapshots
+*
+* The solver only decides whether an iteration is worth a snapshot (a
+* milestone iteration or a new best cost) and copies the tour into a bounded
+* queue; a dedicated thread renders the SVG files. When the queue is full the
+* frame is dropped instead of blocking, so visualization never stalls the
+* search loop. Tour buffers are recycled between frames, so after the first
+* few snapshots offer() does not allocate.
+*/
+
+#ifndef SNAPSHOT_WRITER_H
+#define SNAPSHOT_WRITER_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <utility>
+#include <limits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "visualization.h"
+
+class SnapshotWriter {
+public:
+    // Files are named <base_filename>_iter<iteration>.svg
+    SnapshotWriter(const std::vector<std::pair<double, double>>& points,
+        const std::string& base_filename, std::size_t capacity = 8)
+        : points(points), base_filename(base_filename), capacity(capacity ? capacity : 1),
+        best_cost(std::numeric_limits<double>::infinity()),
+        written(0), dropped(0), stopping(false) {
+        worker = std::thread([this] { writerLoop(); });
+    }
+
+    // Renders the frames still queued, then joins the writer thread
+    ~SnapshotWriter() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        worker.join();
+    }
+
+    SnapshotWriter(const SnapshotWriter&) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter&) = delete;
+
+    // Called from the search loop. A new best counts once it beats the last
+    // one by min_improvement (cost units, the solver's own threshold). Returns
+    // true if the frame was queued, false if the iteration is not a snapshot
+    // or the queue is full.
+    bool offer(const std::vector<int>& tour, int iteration, double cost, double min_improvement) {
+        bool milestone = iteration == 0 || iteration == 100 || iteration == 500 ||
+            iteration == 1000 || iteration == 1500 || iteration == 2000;
+        bool improved = cost < best_cost - min_improvement;
+        if (!milestone && !improved) return false;
+        if (improved) best_cost = cost;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        if (queue.size() >= capacity) {
+            dropped++;
+            return false;
+        }
+        Frame frame;
+        if (!spare.empty()) {
+            frame.tour = std::move(spare.back());
+            spare.pop_back();
+        }
+        lock.unlock();
+
+        // Copy outside the lock so the writer thread is never held up by it
+        frame.tour.assign(tour.begin(), tour.end());
+        frame.iteration = iteration;
+        frame.cost = cost;
+
+        lock.lock();
+        queue.push_back(std::move(frame));
+        lock.unlock();
+        wake.notify_one();
+        return true;
+    }
+
+    std::size_t getWritten() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return written;
+    }
+
+    std::size_t getDropped() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return dropped;
+    }
+
+private:
+    struct Frame {
+        std::vector<int> tour;
+        int iteration = 0;
+        double cost = 0.0;
+    };
+
+    const std::vector<std::pair<double, double>> points;
+    const std::string base_filename;
+    const std::size_t capacity;
+    double best_cost;              // only touched by the solver thread
+
+    std::deque<Frame> queue;
+    std::vector<std::vector<int>> spare;
+    std::size_t written;
+    std::size_t dropped;
+    bool stopping;
+    mutable std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+
+    void writerLoop() {
+        for (;;) {
+            Frame frame;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                wake.wait(lock, [this] { return stopping || !queue.empty(); });
+                if (queue.empty()) return;  // stopping and drained
+                frame = std::move(queue.front());
+                queue.pop_front();
+            }
+
+            BoardVisualizer::generateSVG(points, frame.tour,
+                base_filename + "_iter" + std::to_string(frame.iteration) + ".svg",
+                true, frame.iteration, frame.cost);
+
+            std::lock_guard<std::mutex> lock(mutex);
+            written++;
+            spare.push_back(std::move(frame.tour));
+        }
+    }
+};
+
+#endif /* SNAPSHOT_WRITER_H */
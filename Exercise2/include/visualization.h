@@ -1,23 +1,33 @@
+/**
+* @file visualization.h
+* @brief SVG rendering of boards and drilling tours
+*
+* Documents are built in memory and written with a single write:
+* - the tour is one <path> polyline (or GRADIENT_BANDS paths when colored
+*   by visiting order) instead of one <line> per edge
+* - holes are one <path> of zero-length round-capped strokes; labels are
+*   only emitted up to LABEL_MAX_POINTS holes
+* - numbers are formatted with std::to_chars, one decimal place
+* - downsample_px > 0 drops tour vertices closer than that many pixels to
+*   the previous vertex and keeps one hole per downsample_px grid cell, so
+*   the file size of very large panels is bounded by the picture size
+*   rather than the hole count
+*/
+
 #ifndef VISUALIZATION_H
 #define VISUALIZATION_H
 
 #include <fstream>
-#include <sstream>
 #include <vector>
 #include <utility>
 #include <algorithm>
-#include <iomanip>
-#include <limits>
 #include <string>
 #include <cmath>
+#include <charconv>
 #include <filesystem>
 
 using namespace std;
 
-namespace {
-    double best_recorded_cost = numeric_limits<double>::infinity();
-}
-
 class BoardVisualizer {
 private:
     // Visualization constants
@@ -28,13 +38,34 @@ private:
     static constexpr double TEXT_OFFSET_X = 15.0;
     static constexpr double TEXT_OFFSET_Y = 5.0;
     static constexpr double PATH_STROKE_WIDTH = 2.0;
+    static constexpr size_t LABEL_MAX_POINTS = 200;
+    static constexpr size_t GRADIENT_BANDS = 16;
+
+    static void appendNumber(string& out, double value, int decimals = 1) {
+        char buf[32];
+        auto result = to_chars(buf, buf + sizeof(buf), value, chars_format::fixed, decimals);
+        char* end = result.ptr;
+        // 12.0 -> 12, -0 -> 0
+        if (decimals > 0) {
+            while (end[-1] == '0') --end;
+            if (end[-1] == '.') --end;
+        }
+        if (end - buf == 2 && buf[0] == '-' && buf[1] == '0') {
+            out += '0';
+            return;
+        }
+        out.append(buf, end);
+    }
 
-    static double& getBestRecordedCost() {
-        return best_recorded_cost;
+    static void appendInt(string& out, long long value) {
+        char buf[24];
+        auto result = to_chars(buf, buf + sizeof(buf), value);
+        out.append(buf, result.ptr);
     }
 
     static void calculateBounds(const vector<pair<double, double>>& points,
         double& minX, double& minY, double& maxX, double& maxY) {
+        minX = minY = maxX = maxY = 0.0;
         if (points.empty()) return;
 
         // Initialize with first point
@@ -56,76 +87,172 @@ private:
         scale = maxDim > 0 ? BASE_SVG_SIZE / maxDim : 1.0;
     }
 
-    static void writeSearchMetrics(ofstream& file, double x, double y,
+    static void writeSearchMetrics(string& out, double x, double y,
         int iteration, double currentCost, double textSize) {
-        file << "<text x=\"" << x << "\" y=\"" << y
-            << "\" font-family=\"Arial\" font-size=\"" << textSize
-            << "\" fill=\"black\">";
+        out += "<text x=\"";
+        appendNumber(out, x);
+        out += "\" y=\"";
+        appendNumber(out, y);
+        out += "\" font-family=\"Arial\" font-size=\"";
+        appendNumber(out, textSize);
+        out += "\" fill=\"black\">";
         if (iteration >= 0) {
-            file << "Iteration: " << iteration;
+            out += "Iteration: ";
+            appendInt(out, iteration);
         }
         if (currentCost >= 0) {
-            file << " Cost: " << fixed << setprecision(2) << currentCost;
+            out += " Cost: ";
+            appendNumber(out, currentCost, 2);
         }
-        file << "</text>\n";
+        out += "</text>\n";
+    }
+
+    static void appendPoint(string& out, char command, double x, double y) {
+        out += command;
+        appendNumber(out, x);
+        out += ' ';
+        appendNumber(out, y);
     }
 
-    static void drawNodes(ofstream& file,
+    static void drawNodes(string& out,
         const vector<pair<double, double>>& points,
-        double scale) {
-        file << "<g>\n";
+        double scale, double downsample_px) {
+        // Every hole is a zero-length segment with round caps, i.e. a dot
+        out += "<path fill=\"none\" stroke=\"blue\" stroke-linecap=\"round\" stroke-width=\"";
+        appendNumber(out, 2 * POINT_RADIUS);
+        out += "\" d=\"";
+
+        // Downsampling keeps one hole per downsample_px grid cell
+        double minX, minY, maxX, maxY;
+        calculateBounds(points, minX, minY, maxX, maxY);
+        size_t columns = 0;
+        vector<bool> occupied;
+        if (downsample_px > 0) {
+            columns = static_cast<size_t>((maxX - minX) * scale / downsample_px) + 1;
+            size_t rows = static_cast<size_t>((maxY - minY) * scale / downsample_px) + 1;
+            occupied.assign(columns * rows, false);
+        }
         for (size_t i = 0; i < points.size(); ++i) {
             double x = points[i].first * scale;
             double y = points[i].second * scale;
+            if (downsample_px > 0) {
+                size_t cell = static_cast<size_t>((y - minY * scale) / downsample_px) * columns +
+                    static_cast<size_t>((x - minX * scale) / downsample_px);
+                if (occupied[cell]) continue;
+                occupied[cell] = true;
+            }
+            appendPoint(out, 'M', x, y);
+            out += "h0";
+        }
+        out += "\"/>\n";
 
-            // Draw point
-            file << "<circle cx=\"" << x << "\" cy=\"" << y
-                << "\" r=\"" << POINT_RADIUS << "\" fill=\"blue\"/>\n";
-
-            // Position text
-            double textX = x + TEXT_OFFSET_X;
-            double textY = y + TEXT_OFFSET_Y;
-
-            file << "<text x=\"" << textX << "\" y=\"" << textY
-                << "\" font-family=\"Arial\" font-size=\"" << TEXT_SIZE
-                << "\" fill=\"black\">" << i << "</text>\n";
+        if (points.size() > LABEL_MAX_POINTS) return;
+        out += "<g font-family=\"Arial\" font-size=\"";
+        appendNumber(out, TEXT_SIZE);
+        out += "\" fill=\"black\">\n";
+        for (size_t i = 0; i < points.size(); ++i) {
+            out += "<text x=\"";
+            appendNumber(out, points[i].first * scale + TEXT_OFFSET_X);
+            out += "\" y=\"";
+            appendNumber(out, points[i].second * scale + TEXT_OFFSET_Y);
+            out += "\">";
+            appendInt(out, static_cast<long long>(i));
+            out += "</text>\n";
         }
-        file << "</g>\n";
+        out += "</g>\n";
     }
 
-    static void drawPath(ofstream& file,
+    static void drawPath(string& out,
         const vector<pair<double, double>>& points,
         const vector<int>& tour,
         double scale,
-        bool useGradient = true) {
+        bool useGradient,
+        double downsample_px) {
 
         if (tour.size() < 2) return;
 
-        file << "<g>\n";
-        for (size_t i = 0; i < tour.size() - 1; ++i) {
-            int idx1 = tour[i];
-            int idx2 = tour[i + 1];
-
-            if (idx1 >= 0 && idx1 < static_cast<int>(points.size()) &&
-                idx2 >= 0 && idx2 < static_cast<int>(points.size())) {
+        // Colour runs from blue to red along the tour; each band is one path
+        // in the colour of its middle edge
+        size_t edges = tour.size() - 1;
+        size_t bands = useGradient ? min(GRADIENT_BANDS, edges) : 1;
+        double min_step2 = downsample_px * downsample_px;
+
+        for (size_t band = 0; band < bands; ++band) {
+            size_t first = edges * band / bands;
+            size_t last = edges * (band + 1) / bands;   // edges [first, last)
+            int colorVal = useGradient ?
+                static_cast<int>((255.0 * (first + last) / 2) / edges) : 128;
+
+            out += "<path fill=\"none\" stroke=\"rgb(";
+            appendInt(out, colorVal);
+            out += ",0,";
+            appendInt(out, 255 - colorVal);
+            out += ")\" stroke-width=\"";
+            appendNumber(out, PATH_STROKE_WIDTH);
+            out += "\" stroke-linejoin=\"round\" d=\"";
+
+            // Invalid indices break the polyline, like a skipped <line>
+            bool open = false;
+            double lastX = 0, lastY = 0;
+            for (size_t i = first; i <= last; ++i) {
+                int idx = tour[i];
+                if (idx < 0 || idx >= static_cast<int>(points.size())) {
+                    open = false;
+                    continue;
+                }
+                double x = points[idx].first * scale;
+                double y = points[idx].second * scale;
+                if (open && i != last && min_step2 > 0) {
+                    double dx = x - lastX, dy = y - lastY;
+                    if (dx * dx + dy * dy < min_step2) continue;
+                }
+                appendPoint(out, open ? 'L' : 'M', x, y);
+                open = true;
+                lastX = x;
+                lastY = y;
+            }
+            out += "\"/>\n";
+        }
+    }
 
-                int colorVal = useGradient ?
-                    static_cast<int>((255.0 * i) / (tour.size() - 1)) : 128;
+    static void appendHeader(string& out, double x, double y, double width, double height) {
+        out += "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
+            "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"";
+        appendNumber(out, width);
+        out += "\" height=\"";
+        appendNumber(out, height);
+        out += "\" viewBox=\"";
+        appendNumber(out, x);
+        out += ' ';
+        appendNumber(out, y);
+        out += ' ';
+        appendNumber(out, width);
+        out += ' ';
+        appendNumber(out, height);
+        out += "\">\n";
+    }
 
-                double x1 = points[idx1].first * scale;
-                double y1 = points[idx1].second * scale;
-                double x2 = points[idx2].first * scale;
-                double y2 = points[idx2].second * scale;
+    static void appendBackground(string& out, double x, double y, double width, double height) {
+        out += "<rect x=\"";
+        appendNumber(out, x);
+        out += "\" y=\"";
+        appendNumber(out, y);
+        out += "\" width=\"";
+        appendNumber(out, width);
+        out += "\" height=\"";
+        appendNumber(out, height);
+        out += "\" fill=\"white\"/>\n";
+    }
 
-                file << "<line "
-                    << "x1=\"" << x1 << "\" y1=\"" << y1
-                    << "\" x2=\"" << x2 << "\" y2=\"" << y2
-                    << "\" stroke=\"rgb(" << colorVal << ",0,"
-                    << (255 - colorVal) << ")\" "
-                    << "stroke-width=\"" << PATH_STROKE_WIDTH << "\"/>\n";
-            }
+    static void writeFile(const string& filename, const string& content) {
+        filesystem::path dir = filesystem::path(filename).parent_path();
+        if (!dir.empty() && !filesystem::exists(dir)) {
+            filesystem::create_directories(dir);
         }
-        file << "</g>\n";
+
+        ofstream file(filename, ios::binary);
+        if (!file.is_open()) return;
+        file.write(content.data(), static_cast<streamsize>(content.size()));
     }
 
 public:
@@ -134,19 +261,10 @@ public:
         const string& filename,
         bool showPath = true,
         int iteration = -1,
-        double currentCost = -1.0) {
+        double currentCost = -1.0,
+        double downsample_px = 0.0) {
 
         try {
-            filesystem::path filePath(filename);
-            filesystem::path dir = filePath.parent_path();
-
-            if (!dir.empty() && !filesystem::exists(dir)) {
-                filesystem::create_directories(dir);
-            }
-
-            ofstream file(filename);
-            if (!file.is_open()) return;
-
             // Calculate bounds
             double minX, minY, maxX, maxY;
             calculateBounds(points, minX, minY, maxX, maxY);
@@ -165,36 +283,30 @@ public:
             double width = (maxX - minX) * scale;
             double height = (maxY - minY) * scale;
 
-            // Write SVG header
-            file << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
-                << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
-                << "width=\"" << width << "\" height=\"" << height << "\" "
-                << "viewBox=\"" << minX * scale << " " << minY * scale << " "
-                << width << " " << height << "\">\n";
-
-            // Background
-            file << "<rect x=\"" << minX * scale << "\" y=\"" << minY * scale
-                << "\" width=\"" << width << "\" height=\"" << height
-                << "\" fill=\"white\"/>\n";
+            string out;
+            out.reserve(512 + points.size() * (points.size() <= LABEL_MAX_POINTS ? 64 : 16) +
+                tour.size() * 12);
+            appendHeader(out, minX * scale, minY * scale, width, height);
+            appendBackground(out, minX * scale, minY * scale, width, height);
 
             // Draw path if requested
             if (showPath) {
-                drawPath(file, points, tour, scale);
+                drawPath(out, points, tour, scale, true, downsample_px);
             }
 
             // Draw nodes
-            drawNodes(file, points, scale);
+            drawNodes(out, points, scale, downsample_px);
 
             // Add metrics if available
             if (iteration >= 0 || currentCost >= 0) {
-                writeSearchMetrics(file,
+                writeSearchMetrics(out,
                     minX * scale + BASE_MARGIN / 2,
                     minY * scale + BASE_MARGIN / 2,
                     iteration, currentCost, TEXT_SIZE * 1.2);
             }
 
-            file << "</svg>\n";
-            file.close();
+            out += "</svg>\n";
+            writeFile(filename, out);
         }
         catch (const exception&) {
             // Silent error handling
@@ -207,19 +319,10 @@ public:
         const vector<int>& finalTour,
         const string& filename,
         double initialCost,
-        double finalCost) {
+        double finalCost,
+        double downsample_px = 0.0) {
 
         try {
-            filesystem::path filePath(filename);
-            filesystem::path dir = filePath.parent_path();
-
-            if (!dir.empty() && !filesystem::exists(dir)) {
-                filesystem::create_directories(dir);
-            }
-
-            ofstream file(filename);
-            if (!file.is_open()) return;
-
             // Calculate bounds
             double minX, minY, maxX, maxY;
             calculateBounds(points, minX, minY, maxX, maxY);
@@ -239,78 +342,35 @@ public:
             double scale;
             calculateScaling(singleWidth, height, scale);
 
-            file << "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"no\"?>\n"
-                << "<svg xmlns=\"http://www.w3.org/2000/svg\" "
-                << "width=\"" << width * scale << "\" height=\"" << height * scale << "\" "
-                << "viewBox=\"" << minX * scale << " " << minY * scale << " "
-                << width * scale << " " << height * scale << "\">\n";
-
-            // Left side: Initial solution
-            file << "<g transform=\"translate(0,0)\">\n"
-                << "<rect x=\"" << minX * scale << "\" y=\"" << minY * scale
-                << "\" width=\"" << singleWidth * scale
-                << "\" height=\"" << height * scale
-                << "\" fill=\"white\"/>\n";
-            drawPath(file, points, initialTour, scale, false);
-            drawNodes(file, points, scale);
-            writeSearchMetrics(file,
-                minX * scale + BASE_MARGIN / 2,
-                minY * scale + BASE_MARGIN / 2,
-                -1, initialCost, TEXT_SIZE * 1.2);
-            file << "</g>\n";
-
-            // Right side: Final solution
-            file << "<g transform=\"translate(" << singleWidth * 1.1 * scale << ",0)\">\n"
-                << "<rect x=\"" << minX * scale << "\" y=\"" << minY * scale
-                << "\" width=\"" << singleWidth * scale
-                << "\" height=\"" << height * scale
-                << "\" fill=\"white\"/>\n";
-            drawPath(file, points, finalTour, scale, false);
-            drawNodes(file, points, scale);
-            writeSearchMetrics(file,
-                minX * scale + BASE_MARGIN / 2,
-                minY * scale + BASE_MARGIN / 2,
-                -1, finalCost, TEXT_SIZE * 1.2);
-            file << "</g>\n";
-
-            file << "</svg>\n";
-            file.close();
+            string out;
+            out.reserve(1024 + 2 * (points.size() * (points.size() <= LABEL_MAX_POINTS ? 64 : 16) +
+                initialTour.size() * 12));
+            appendHeader(out, minX * scale, minY * scale, width * scale, height * scale);
+
+            // Left side: initial solution, right side: final solution
+            const vector<int>* tours[2] = { &initialTour, &finalTour };
+            double costs[2] = { initialCost, finalCost };
+            for (int side = 0; side < 2; side++) {
+                out += "<g transform=\"translate(";
+                appendNumber(out, side == 0 ? 0.0 : singleWidth * 1.1 * scale);
+                out += ",0)\">\n";
+                appendBackground(out, minX * scale, minY * scale, singleWidth * scale, height * scale);
+                drawPath(out, points, *tours[side], scale, false, downsample_px);
+                drawNodes(out, points, scale, downsample_px);
+                writeSearchMetrics(out,
+                    minX * scale + BASE_MARGIN / 2,
+                    minY * scale + BASE_MARGIN / 2,
+                    -1, costs[side], TEXT_SIZE * 1.2);
+                out += "</g>\n";
+            }
+
+            out += "</svg>\n";
+            writeFile(filename, out);
         }
         catch (const exception&) {
             // Silent error handling
         }
     }
-
-    static void saveKeySnapshots(
-        const vector<pair<double, double>>& points,
-        const vector<int>& tour,
-        const string& baseFilename,
-        int iteration,
-        double cost,
-        bool isCalibration = true) {
-
-        if (isCalibration) return;
-
-        bool shouldSave = false;
-
-        // Save at milestone iterations
-        if (iteration == 0 || iteration == 100 || iteration == 500 ||
-            iteration == 1000 || iteration == 1500 || iteration == 2000) {
-            shouldSave = true;
-        }
-
-        // Save when we find a significantly better solution
-        if (cost < getBestRecordedCost() - 0.01) {
-            getBestRecordedCost() = cost;
-            shouldSave = true;
-        }
-
-        if (shouldSave) {
-            string filename = baseFilename + "_iter" +
-                to_string(iteration) + ".svg";
-            generateSVG(points, tour, filename, true, iteration, cost);
-        }
-    }
 };
 
-#endif
\ No newline at end of file
+#endif
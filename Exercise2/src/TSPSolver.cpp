@@ -1,34 +1,52 @@
 #include "TSPSolver.h"
 #include "data_generator.h"
-#include "visualization.h"
+#include "snapshot_writer.h"
+#include "search_trace.h"
 #include <limits>
-#include <cstdlib>
-#include <ctime>
 #include <chrono>
 #include <algorithm>
 
-const int TSPSolver::MAX_ITERATIONS_WITHOUT_IMPROVEMENT = 100;
-const int TSPSolver::INTENSIFICATION_ITERATIONS = 50;
 const int TSPSolver::MIN_MOVES_FOR_STATS = 10;
-const double TSPSolver::IMPROVEMENT_THRESHOLD = 0.01;
+const double TSPSolver::IMPROVEMENT_FRACTION = 2e-4;
+
+namespace {
+    // Mean cost between two holes, over up to 32 evenly spaced full rows
+    double meanArcCost(const TSP& tsp) {
+        if (tsp.n < 2) return 0.0;
+        int rows = std::min(tsp.n, 32);
+        double total = 0.0;
+        for (int r = 0; r < rows; r++) {
+            int i = static_cast<int>(static_cast<long long>(r) * tsp.n / rows);
+            for (int j = 0; j < tsp.n; j++) total += tsp.arc(i, j);
+        }
+        return total / (static_cast<double>(rows) * (tsp.n - 1));
+    }
+}
 
-TSPSolver::TSPSolver() :
-    tabu_tenure(7), max_iterations(1000),
+TSPSolver::TSPSolver(unsigned seed) :
+    initial_tabu_tenure(7), tabu_tenure(7), max_iterations(1000), iterations_run(0),
     min_tenure(5), max_tenure(20),
+    max_iterations_without_improvement(100), intensification_iterations(50),
     iterations_without_improvement(0),
     best_known_value(std::numeric_limits<double>::max()),
     in_intensification_phase(false),
-    best_intensification_solution(TSPSolution(TSP())) {
-    srand(static_cast<unsigned>(time(nullptr)));
-}
+    improvement_threshold(0.0),
+    rng(seed ? seed : std::random_device{}()),
+    snapshots(nullptr),
+    trace(nullptr),
+    best_intensification_solution(TSPSolution(TSP())) {}
 
 void TSPSolver::initializeMemoryStructures(int size) {
     frequency_matrix.clear();
     frequency_matrix.resize(size, std::vector<int>(size, 0));
     move_history.clear();
-    search_history.clear();
     tabu_list.clear();
     best_intensification_value = std::numeric_limits<double>::max();
+
+    // Reactive state left over from a previous search on this solver
+    tabu_tenure = initial_tabu_tenure;
+    iterations_without_improvement = 0;
+    in_intensification_phase = false;
 }
 
 void TSPSolver::updateMoveFrequency(const Move& move, double improvement) {
@@ -38,37 +56,22 @@ void TSPSolver::updateMoveFrequency(const Move& move, double improvement) {
     freq.avg_improvement = (freq.avg_improvement * (freq.frequency - 1) + improvement) / freq.frequency;
 }
 
-void TSPSolver::updateSearchStats(int iteration, double current_value,
-    double previous_value, double time_elapsed) {
-    double improvement = previous_value - current_value;
-    double improvement_percentage = (previous_value != 0) ?
-        (improvement / previous_value) * 100.0 : 0.0;
-
-    search_history.push_back({
-        iteration,
-        current_value,
-        tabu_tenure,
-        improvement > IMPROVEMENT_THRESHOLD,
-        improvement_percentage,
-        time_elapsed
-        });
-}
-
 bool TSPSolver::solveWithTabuSearch(const TSP& tsp, const TSPSolution& initSol,
-    TSPSolution& bestSol, const std::vector<std::pair<double, double>>& points,
-    int save_every) {
+    TSPSolution& bestSol, int save_every) {
     try {
         int iteration = 0;
         bool stop = false;
-        auto start_time = std::chrono::high_resolution_clock::now();
+        auto start_time = std::chrono::steady_clock::now();
 
         initializeMemoryStructures(tsp.n);
+        improvement_threshold = tsp.integer_costs ? 0.5 : IMPROVEMENT_FRACTION * meanArcCost(tsp);
 
         TSPSolution currSol(initSol);
         double bestValue = evaluate(currSol, tsp);
         double currValue = bestValue;
         bestSol = currSol;
         best_known_value = bestValue;
+        if (trace) trace->begin(currSol.sequence);
 
         while (!stop) {
             double prev_value = currValue;
@@ -89,12 +92,11 @@ bool TSPSolver::solveWithTabuSearch(const TSP& tsp, const TSPSolution& initSol,
 
             // Update statistics and memory structures
             updateMoveFrequency(move, prev_value - currValue);
-            auto current_time = std::chrono::duration_cast<std::chrono::milliseconds>
-                (std::chrono::high_resolution_clock::now() - start_time).count() / 1000.0;
-            updateSearchStats(iteration, currValue, prev_value, current_time);
 
             // Adjust search strategy based on progress
+            uint8_t trace_flags = 0;
             if (shouldIntensify(currValue, bestValue)) {
+                trace_flags = SearchTrace::IMPROVED | SearchTrace::INTENSIFIED;
                 bestValue = currValue;
                 bestSol = currSol;
                 in_intensification_phase = true;
@@ -102,23 +104,32 @@ bool TSPSolver::solveWithTabuSearch(const TSP& tsp, const TSPSolution& initSol,
                 currValue = evaluate(currSol, tsp);
             }
             else if (shouldDiversify()) {
+                trace_flags = SearchTrace::DIVERSIFIED;
                 diversifySearch(currSol);
                 currValue = evaluate(currSol, tsp);
             }
 
-            if (iteration % save_every == 0) {
-                BoardVisualizer::saveKeySnapshots(points, currSol.sequence,
-                    "visualizations/solution", iteration, currValue);
+            if (snapshots && iteration % save_every == 0) {
+                snapshots->offer(currSol.sequence, iteration, tsp.toLength(currValue),
+                    tsp.toLength(improvement_threshold));
             }
 
             adjustTabuTenure(currValue);
 
+            if (trace) {
+                auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start_time).count();
+                trace->record(iteration, static_cast<uint32_t>(elapsed), tsp.toLength(currValue),
+                    move.from, move.to, tabu_tenure, trace_flags, currSol.sequence);
+            }
+
             iteration++;
             if (iteration >= max_iterations) {
                 stop = true;
             }
         }
 
+        iterations_run = iteration;
         return true;
     }
     catch (std::exception& e) {
@@ -130,7 +141,7 @@ bool TSPSolver::solveWithTabuSearch(const TSP& tsp, const TSPSolution& initSol,
 void TSPSolver::adjustTabuTenure(double current_value) {
     if (current_value >= best_known_value) {
         iterations_without_improvement++;
-        if (iterations_without_improvement > MAX_ITERATIONS_WITHOUT_IMPROVEMENT / 2) {
+        if (iterations_without_improvement > max_iterations_without_improvement / 2) {
             tabu_tenure = std::min(tabu_tenure + 2, max_tenure);
         }
     }
@@ -151,7 +162,7 @@ void TSPSolver::intensifySearch(const TSP& tsp, TSPSolution& current_sol) {
     TSPSolution best_local = current_sol;
     double best_local_value = backup_value;
 
-    for (int i = 0; i < INTENSIFICATION_ITERATIONS; i++) {
+    for (int i = 0; i < intensification_iterations; i++) {
         Move move = findBestNeighbor(tsp, current_sol, i);
         if (move.cost_change >= tsp.infinite) break;
 
@@ -184,10 +195,11 @@ void TSPSolver::intensifySearch(const TSP& tsp, TSPSolution& current_sol) {
 }
 
 void TSPSolver::diversifySearch(TSPSolution& current_sol) {
-    // Use frequency information to guide diversification
+    // Use frequency information to guide diversification. Node 0 is the
+    // depot at both ends of the sequence and must not be swapped
     std::vector<std::pair<int, int>> least_used_moves;
 
-    for (size_t i = 0; i < frequency_matrix.size(); i++) {
+    for (size_t i = 1; i < frequency_matrix.size(); i++) {
         for (size_t j = i + 1; j < frequency_matrix.size(); j++) {
             if (frequency_matrix[i][j] < frequency_matrix.size() / 4) {
                 least_used_moves.push_back({ i, j });
@@ -198,7 +210,8 @@ void TSPSolver::diversifySearch(TSPSolution& current_sol) {
     // Apply a series of less-frequently used moves
     int num_moves = current_sol.sequence.size() / 3;
     for (int i = 0; i < num_moves && !least_used_moves.empty(); i++) {
-        int idx = rand() % least_used_moves.size();
+        int idx = std::uniform_int_distribution<int>(
+            0, static_cast<int>(least_used_moves.size()) - 1)(rng);
         auto move = least_used_moves[idx];
 
         // Find positions in sequence
@@ -219,42 +232,67 @@ void TSPSolver::diversifySearch(TSPSolution& current_sol) {
 }
 
 bool TSPSolver::shouldIntensify(double current_value, double best_value) const {
-    return current_value < best_value - IMPROVEMENT_THRESHOLD ||
+    return current_value < best_value - improvement_threshold ||
         (iterations_without_improvement == 0 && current_value < best_value);
 }
 
 bool TSPSolver::shouldDiversify() const {
-    return iterations_without_improvement >= MAX_ITERATIONS_WITHOUT_IMPROVEMENT ||
+    return iterations_without_improvement >= max_iterations_without_improvement ||
         (tabu_tenure >= max_tenure - 2 &&
-            iterations_without_improvement >= MAX_ITERATIONS_WITHOUT_IMPROVEMENT / 2);
+            iterations_without_improvement >= max_iterations_without_improvement / 2);
 }
 
 TSPSolver::Move TSPSolver::findBestNeighbor(const TSP& tsp, const TSPSolution& currSol,
     int iteration) {
-    Move bestMove;
-    bestMove.cost_change = tsp.infinite;
-
-    for (std::size_t a = 1; a < currSol.sequence.size() - 2; a++) {
-        int h = currSol.sequence[a - 1];
-        int i = currSol.sequence[a];
+    if (tsp.integer_costs) {
+        return scanTwoOpt(tsp.icost, currSol, iteration, tsp.infinite);
+    }
+    return scanTwoOpt(tsp.cost, currSol, iteration, tsp.infinite);
+}
 
-        for (std::size_t b = a + 1; b < currSol.sequence.size() - 1; b++) {
-            int j = currSol.sequence[b];
-            int l = currSol.sequence[b + 1];
+template <typename T>
+TSPSolver::Move TSPSolver::scanTwoOpt(const std::vector<std::vector<T>>& cost,
+    const TSPSolution& currSol, int iteration, double infinite) {
+    // Deltas stay in the matrix type. DistanceMatrix::buildInteger caps every
+    // cost at INT32_MAX / 4, so the four-term integer sum cannot overflow
+    Move bestMove;
+    bestMove.cost_change = infinite;
 
-            if (isTabu(i, j, iteration)) {
-                continue;
-            }
+    const std::vector<int>& seq = currSol.sequence;
+    const std::size_t m = seq.size();
+    if (m < 4) return bestMove;
 
-            double costChange = calculateMoveCost(tsp, currSol, Move(a, b));
+    // Cost of the tour edge leaving position b, reused by every a
+    std::vector<T> edge(m - 1);
+    for (std::size_t b = 0; b + 1 < m; b++) {
+        edge[b] = cost[seq[b]][seq[b + 1]];
+    }
 
-            if (costChange < bestMove.cost_change) {
+    // No real move reaches the type's maximum, so `best` doubles as "none found"
+    T best = std::numeric_limits<T>::max();
+    for (std::size_t a = 1; a < m - 2; a++) {
+        int h = seq[a - 1];
+        int i = seq[a];
+        const T* rowH = cost[h].data();
+        const T* rowI = cost[i].data();
+        const T removed_hi = edge[a - 1];
+
+        for (std::size_t b = a + 1; b < m - 1; b++) {
+            // Same summation order as calculateMoveCost, so real-valued runs are unchanged
+            T delta = -removed_hi - edge[b] + rowH[seq[b]] + rowI[seq[b + 1]];
+
+            // The tabu list is only consulted for candidates that would win
+            if (delta < best && !isTabu(i, seq[b], iteration)) {
+                best = delta;
                 bestMove.from = static_cast<int>(a);
                 bestMove.to = static_cast<int>(b);
-                bestMove.cost_change = costChange;
             }
         }
     }
+
+    if (bestMove.from >= 0) {
+        bestMove.cost_change = static_cast<double>(best);
+    }
     return bestMove;
 }
 
@@ -278,19 +316,30 @@ bool TSPSolver::isTabu(int from, int to, int iteration) {
 }
 
 double TSPSolver::evaluate(const TSPSolution& sol, const TSP& tsp) const {
-    double total = 0.0;
+    if (tsp.integer_costs) {
+        return tourLength(tsp.icost, sol);
+    }
+    return tourLength(tsp.cost, sol);
+}
+
+template <typename T>
+double TSPSolver::tourLength(const std::vector<std::vector<T>>& cost, const TSPSolution& sol) {
+    using Acc = typename std::conditional<std::is_integral<T>::value, int64_t, double>::type;
+
+    Acc total = 0;
     for (std::size_t i = 0; i < sol.sequence.size() - 1; i++) {
         int from = sol.sequence[i];
         int to = sol.sequence[i + 1];
-        total += tsp.cost[from][to];
+        total += cost[from][to];
     }
-    return total;
+    return static_cast<double>(total);
 }
 
 bool TSPSolver::initRnd(TSPSolution& sol) {
+    if (sol.sequence.size() < 3) return true;
+    std::uniform_int_distribution<int> position(1, static_cast<int>(sol.sequence.size()) - 2);
     for (std::size_t i = 1; i < sol.sequence.size() - 1; i++) {
-        int j = 1 + rand() % (sol.sequence.size() - 2);
-        std::swap(sol.sequence[i], sol.sequence[j]);
+        std::swap(sol.sequence[i], sol.sequence[position(rng)]);
     }
     return true;
 }
@@ -313,5 +362,5 @@ double TSPSolver::calculateMoveCost(const TSP& tsp, const TSPSolution& sol,
     int j = sol.sequence[move.to];
     int l = sol.sequence[move.to + 1];
 
-    return -tsp.cost[h][i] - tsp.cost[j][l] + tsp.cost[h][j] + tsp.cost[i][l];
+    return -tsp.arc(h, i) - tsp.arc(j, l) + tsp.arc(h, j) + tsp.arc(i, l);
 }
\ No newline at end of file
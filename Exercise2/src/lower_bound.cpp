@@ -0,0 +1,156 @@
+#include "lower_bound.h"
+#include <cmath>
+#include <limits>
+#include <chrono>
+#include <algorithm>
+
+double HeldKarpBound::oneTree(const std::vector<double>& cost, int n,
+    const std::vector<double>& pi, std::vector<int>& degree) {
+
+    const double inf = std::numeric_limits<double>::infinity();
+    std::fill(degree.begin(), degree.end(), 0);
+
+    // Prim over nodes 1..n-1
+    std::vector<double> key(n, inf);
+    std::vector<int> parent(n, -1);
+    std::vector<char> in_tree(n, 0);
+    double weight = 0.0;
+
+    key[1] = 0.0;
+    for (int step = 1; step < n; step++) {
+        int u = -1;
+        for (int v = 1; v < n; v++) {
+            if (!in_tree[v] && (u < 0 || key[v] < key[u])) u = v;
+        }
+        in_tree[u] = 1;
+        weight += key[u];
+        if (parent[u] >= 0) {
+            degree[u]++;
+            degree[parent[u]]++;
+        }
+
+        const double* row = &cost[static_cast<std::size_t>(u) * n];
+        for (int v = 1; v < n; v++) {
+            double w = row[v] + pi[u] + pi[v];
+            if (!in_tree[v] && w < key[v]) {
+                key[v] = w;
+                parent[v] = u;
+            }
+        }
+    }
+
+    // Two cheapest edges at node 0
+    int first = -1, second = -1;
+    for (int v = 1; v < n; v++) {
+        double w = cost[v] + pi[0] + pi[v];
+        if (first < 0 || w < cost[first] + pi[0] + pi[first]) {
+            second = first;
+            first = v;
+        }
+        else if (second < 0 || w < cost[second] + pi[0] + pi[second]) {
+            second = v;
+        }
+    }
+    weight += cost[first] + pi[0] + pi[first] + cost[second] + pi[0] + pi[second];
+    degree[0] = 2;
+    degree[first]++;
+    degree[second]++;
+
+    return weight;
+}
+
+double HeldKarpBound::nearestNeighbour(const std::vector<double>& cost, int n) {
+    std::vector<char> visited(n, 0);
+    visited[0] = 1;
+    int current = 0;
+    double total = 0.0;
+    for (int step = 1; step < n; step++) {
+        int next = -1;
+        for (int v = 0; v < n; v++) {
+            if (!visited[v] && (next < 0 || cost[current * n + v] < cost[current * n + next])) {
+                next = v;
+            }
+        }
+        visited[next] = 1;
+        total += cost[current * n + next];
+        current = next;
+    }
+    return total + cost[current * n];
+}
+
+HeldKarpBound::Result HeldKarpBound::compute(const TSP& tsp, double upper_bound) const {
+    auto start = std::chrono::high_resolution_clock::now();
+    const int n = tsp.n;
+
+    Result result;
+    result.bound = 0.0;
+    result.iterations = 0;
+    result.optimal = false;
+    result.penalties.assign(n, 0.0);
+
+    if (n < 3) {
+        // Single possible tour
+        result.bound = n == 2 ? tsp.arc(0, 1) + tsp.arc(1, 0) : 0.0;
+        result.optimal = true;
+        result.time_ms = 0.0;
+        return result;
+    }
+
+    // Dense symmetric copy, row-major
+    std::vector<double> cost(static_cast<std::size_t>(n) * n);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            cost[static_cast<std::size_t>(i) * n + j] = std::min(tsp.arc(i, j), tsp.arc(j, i));
+        }
+    }
+
+    if (upper_bound <= 0.0) upper_bound = nearestNeighbour(cost, n);
+
+    std::vector<double> pi(n, 0.0);
+    std::vector<int> degree(n, 0);
+    double best = -std::numeric_limits<double>::infinity();
+    double lambda = 2.0;
+    const int period = std::max(10, n / 2);   // iterations before halving lambda
+    int since_improvement = 0;
+
+    for (int it = 0; it < max_iterations && lambda > 1e-5; it++) {
+        result.iterations = it + 1;
+
+        double sum_pi = 0.0;
+        for (double p : pi) sum_pi += p;
+        double value = oneTree(cost, n, pi, degree) - 2.0 * sum_pi;
+
+        double norm = 0.0;
+        for (int v = 0; v < n; v++) {
+            double g = degree[v] - 2;
+            norm += g * g;
+        }
+
+        if (value > best + 1e-9) {
+            best = value;
+            result.penalties = pi;
+            since_improvement = 0;
+        }
+        else if (++since_improvement >= period) {
+            lambda *= 0.5;
+            since_improvement = 0;
+        }
+
+        // A 1-tree with all degrees 2 is a tour: the bound is tight
+        if (norm == 0.0) {
+            result.optimal = true;
+            break;
+        }
+        if (best >= upper_bound - 1e-9) break;
+
+        double step = lambda * (upper_bound - value) / norm;
+        for (int v = 0; v < n; v++) {
+            pi[v] += step * (degree[v] - 2);
+        }
+    }
+
+    result.bound = tsp.integer_costs ? std::ceil(best - 1e-9) : best;
+    result.time_ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return result;
+}
@@ -6,12 +6,20 @@
 #include <direct.h>
 #include <filesystem>
 #include <fstream>
+#include <sstream>
 #include <limits>
 #include <numeric>
 #include "TSPSolver.h"
+#include "lower_bound.h"
+#include "bench_stats.h"
 #include "data_generator.h"
+#include "batch_generator.h"
+#include "cost_model.h"
 #include "parameter_calibration.h"
+#include "parameter_store.h"
 #include "visualization.h"
+#include "snapshot_writer.h"
+#include "search_trace.h"
 
 int status;
 char errmsg[255];
@@ -22,8 +30,12 @@ struct TestResults {
     double improvement_percentage;
     double execution_time;
     double avg_time;
+    double median_time;
     double best_cost;
     double worst_cost;
+    double lower_bound;  // Held-Karp 1-tree bound
+    double best_gap;     // percent above the bound
+    double avg_gap;
 };
 
 bool createDirectory(const std::string& path) {
@@ -33,135 +45,137 @@ bool createDirectory(const std::string& path) {
 void generateInstanceSet(const std::vector<std::tuple<int, int, int>>& board_configs,
     int instances_per_size) {
 
-    createDirectory("data");
-    createDirectory("data/small");
-    createDirectory("data/medium");
-    createDirectory("data/large");
-
-    for (const auto& config : board_configs) {
-        int width = std::get<0>(config);
-        int height = std::get<1>(config);
-        int components = std::get<2>(config);
-
-        for (int i = 0; i < instances_per_size; i++) {
-            auto costs = TSPGenerator::generateCircuitBoard(width, height, components);
-            auto now = std::chrono::system_clock::now();
-            auto timestamp = std::chrono::duration_cast<std::chrono::seconds>(
-                now.time_since_epoch()).count();
-
-            std::string category = costs.size() <= 20 ? "small" :
-                costs.size() <= 35 ? "medium" : "large";
-
-            std::string filename = "data/" + category + "/board_" +
-                std::to_string(width) + "x" + std::to_string(height) + "_" +
-                std::to_string(timestamp) + "_" + std::to_string(i) + ".dat";
-
-            try {
-                TSPGenerator::saveToFile(filename, costs,
-                    "Circuit board instance\nSize: " + category + "\nNodes: " +
-                    std::to_string(costs.size()));
+    try {
+        BatchGenerator generator("data");
+        auto manifest = generator.run(board_configs, 1, instances_per_size);
 
-                std::cout << "Generated instance: " << filename
-                    << " (nodes: " << costs.size() << ")\n";
-            }
-            catch (const std::exception& e) {
-                std::cout << "Error saving instance: " << e.what() << "\n";
-            }
+        for (const auto& entry : manifest) {
+            std::cout << "Generated instance: " << entry.filename
+                << " (nodes: " << entry.nodes << ")\n";
         }
+        std::cout << "Manifest: " << generator.manifestPath() << "\n";
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error generating instances: " << e.what() << "\n";
     }
 }
 
-void calculateStats(const std::vector<double>& values, double& avg, double& min, double& max) {
-    if (values.empty()) return;
-
-    min = values[0];
-    max = values[0];
-    double sum = 0.0;
+// Production-size panels (hole coordinates only) for benchmarking at scale
+void generatePanelSet(const std::vector<int>& hole_counts, int instances_per_size) {
+    try {
+        BatchGenerator generator("data");
+        auto manifest = generator.runPanels(hole_counts, 1, instances_per_size);
 
-    for (const auto& val : values) {
-        sum += val;
-        if (val < min) min = val;
-        if (val > max) max = val;
+        for (const auto& entry : manifest) {
+            std::cout << "Generated panel: " << entry.filename
+                << " (holes: " << entry.holes << ", boards: " << entry.boards << ")\n";
+        }
+        std::cout << "Panel manifest: " << generator.panelManifestPath() << "\n";
+    }
+    catch (const std::exception& e) {
+        std::cout << "Error generating panels: " << e.what() << "\n";
     }
-
-    avg = sum / values.size();
 }
 
-TestResults runBenchmark(const TSP& tsp, TSPSolver& solver, int num_runs = 10) {
+// Every run gets a fresh solver seeded from `seed`, so no reactive state
+// carries over and the benchmark is repeatable
+TestResults runBenchmark(const TSP& tsp, const ParameterCalibration::ClassParameters& params,
+    int num_runs = 10, unsigned seed = 1) {
     std::vector<double> solution_costs;
     std::vector<double> run_times;
+    std::vector<double> gaps;
     double initial_cost = 0.0;
 
+    // One bound per instance gauges every run
+    HeldKarpBound::Result bound = HeldKarpBound().compute(tsp);
+    double lower_bound = tsp.toLength(bound.bound);
+
     for (int run = 0; run < num_runs; run++) {
+        TSPSolver solver(seed + run);
+        params.applyTo(solver);
+
         TSPSolution initial(tsp);
         TSPSolution best(tsp);
         solver.initRnd(initial);
 
         if (run == 0) {
-            initial_cost = solver.evaluate(initial, tsp);
+            initial_cost = tsp.toLength(solver.evaluate(initial, tsp));
         }
 
-        auto start = std::chrono::high_resolution_clock::now();
-        solver.solveWithTabuSearch(tsp, initial, best, {});
-        auto end = std::chrono::high_resolution_clock::now();
+        auto start = std::chrono::steady_clock::now();
+        solver.solveWithTabuSearch(tsp, initial, best);
+        auto end = std::chrono::steady_clock::now();
 
-        double cost = solver.evaluate(best, tsp);
-        double time = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+        double cost = tsp.toLength(solver.evaluate(best, tsp));
+        double time = std::chrono::duration<double, std::milli>(end - start).count();
 
         solution_costs.push_back(cost);
         run_times.push_back(time);
+        gaps.push_back(HeldKarpBound::gap(cost, lower_bound));
     }
 
-    double avg_cost, min_cost, max_cost, avg_time, min_time, max_time;
-    calculateStats(solution_costs, avg_cost, min_cost, max_cost);
-    calculateStats(run_times, avg_time, min_time, max_time);
+    SampleSummary costs = SampleSummary::of(solution_costs);
+    SampleSummary times = SampleSummary::of(run_times);
+    SampleSummary gap = SampleSummary::of(gaps);
 
     std::cout << "Benchmark Results (" << num_runs << " runs):\n"
-        << "  Average Cost: " << std::fixed << std::setprecision(2) << avg_cost << "\n"
-        << "  Best Cost: " << min_cost << "\n"
-        << "  Worst Cost: " << max_cost << "\n"
-        << "  Average Time: " << avg_time << "ms\n";
+        << "  Average Cost: " << std::fixed << std::setprecision(2) << costs.mean << "\n"
+        << "  Best Cost: " << costs.min << "\n"
+        << "  Worst Cost: " << costs.max << "\n"
+        << "  Time: median " << std::setprecision(3) << times.median << "ms [95% CI "
+        << times.median_ci_low << ", " << times.median_ci_high << "], average " << times.mean
+        << "ms, p90 " << times.p90 << "ms\n" << std::setprecision(2)
+        << "  Lower Bound: " << lower_bound << " (1-tree, " << bound.iterations
+        << " iterations, " << bound.time_ms << "ms)\n"
+        << "  Gap: best " << gap.min << "%, median " << gap.median << "%, worst " << gap.max << "%\n";
 
     TestResults results;
     results.initial_cost = initial_cost;
-    results.final_cost = min_cost;
-    results.improvement_percentage = ((initial_cost - min_cost) / initial_cost) * 100.0;
-    results.execution_time = avg_time;
-    results.avg_time = avg_time;
-    results.best_cost = min_cost;
-    results.worst_cost = max_cost;
+    results.final_cost = costs.min;
+    results.improvement_percentage = ((initial_cost - costs.min) / initial_cost) * 100.0;
+    results.execution_time = times.mean;
+    results.avg_time = times.mean;
+    results.median_time = times.median;
+    results.best_cost = costs.min;
+    results.worst_cost = costs.max;
+    results.lower_bound = lower_bound;
+    results.best_gap = gap.min;
+    results.avg_gap = gap.mean;
 
     return results;
 }
 
 void solveAndVisualize(const TSP& tsp, const std::vector<std::pair<double, double>>& points,
-    const ParameterCalibration::Parameters& params, const std::string& output_prefix) {
+    const ParameterCalibration::ClassParameters& params, const std::string& output_prefix) {
 
     TSPSolver solver;
-
-    if (tsp.n <= 20) {
-        solver.setTabuTenure(params.small_tenure);
-        solver.setMaxIterations(params.small_iterations);
-    }
-    else if (tsp.n <= 35) {
-        solver.setTabuTenure(params.medium_tenure);
-        solver.setMaxIterations(params.medium_iterations);
-    }
-    else {
-        solver.setTabuTenure(params.large_tenure);
-        solver.setMaxIterations(params.large_iterations);
-    }
+    params.applyTo(solver);
 
     TSPSolution initialSol(tsp);
     solver.initRnd(initialSol);
-    double initialCost = solver.evaluate(initialSol, tsp);
+    double initialCost = tsp.toLength(solver.evaluate(initialSol, tsp));
 
     TSPSolution bestSol(tsp);
-    auto start = std::chrono::high_resolution_clock::now();
-    solver.solveWithTabuSearch(tsp, initialSol, bestSol, points);
-    auto end = std::chrono::high_resolution_clock::now();
+    std::size_t snapshots_dropped;
+    SearchTrace trace;
+    std::chrono::high_resolution_clock::time_point start, end;
+    {
+        // Snapshots render on the writer's thread; leaving the scope waits
+        // for the queued ones, outside the timed region
+        SnapshotWriter snapshots(points, output_prefix + "_search");
+        solver.setSnapshotWriter(&snapshots);
+        solver.setSearchTrace(&trace);
+        start = std::chrono::high_resolution_clock::now();
+        solver.solveWithTabuSearch(tsp, initialSol, bestSol);
+        end = std::chrono::high_resolution_clock::now();
+        solver.setSnapshotWriter(nullptr);
+        solver.setSearchTrace(nullptr);
+        snapshots_dropped = snapshots.getDropped();
+    }
+    trace.setPoints(points);
+    trace.flush(output_prefix + "_trace.bin");
 
-    double finalCost = solver.evaluate(bestSol, tsp);
+    double finalCost = tsp.toLength(solver.evaluate(bestSol, tsp));
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
     BoardVisualizer::generateSVG(points, initialSol.sequence,
@@ -179,18 +193,26 @@ void solveAndVisualize(const TSP& tsp, const std::vector<std::pair<double, doubl
         << "  Final cost: " << finalCost << "\n"
         << "  Improvement: " << std::fixed << std::setprecision(2)
         << improvement << "%\n"
-        << "  Time: " << duration.count() << "ms\n\n";
+        << "  Time: " << duration.count() << "ms\n";
+    if (snapshots_dropped > 0) {
+        std::cout << "  Snapshots dropped: " << snapshots_dropped << "\n";
+    }
+    std::cout << "\n";
 }
 
 void analyzeResults(const std::vector<TestResults>& results, std::ofstream& log_file) {
     double total_improvement = 0.0;
     double total_time = 0.0;
+    double total_gap = 0.0;
+    double total_best_gap = 0.0;
     double best_improvement = 0.0;
     double worst_improvement = (std::numeric_limits<double>::max)();
 
     for (const auto& result : results) {
         total_improvement += result.improvement_percentage;
         total_time += result.execution_time;
+        total_gap += result.avg_gap;
+        total_best_gap += result.best_gap;
         // Replace std::max/min with direct comparisons
         if (result.improvement_percentage > best_improvement) {
             best_improvement = result.improvement_percentage;
@@ -208,11 +230,47 @@ void analyzeResults(const std::vector<TestResults>& results, std::ofstream& log_
         << avg_improvement << "%\n"
         << "Best Improvement: " << best_improvement << "%\n"
         << "Worst Improvement: " << worst_improvement << "%\n"
-        << "Average Execution Time: " << avg_time << "ms\n";
+        << "Average Execution Time: " << avg_time << "ms\n"
+        << "Average Gap to 1-tree Bound: " << total_gap / results.size() << "%\n"
+        << "Average Best Gap to 1-tree Bound: " << total_best_gap / results.size() << "%\n";
 }
 
 int main(int argc, char const* argv[]) {
     try {
+        // --integer-costs: solve on int32 ticks (um, or us for time models) instead of doubles
+        // --cost-model=euclidean|manhattan|chebyshev|trapezoidal
+        // --threads=N: calibration workers (default: all hardware threads)
+        // --calibration=race|grid: F-Race over sampled settings (default) or the full grid
+        // --parameters=FILE: calibration store (default results/parameter_store.txt),
+        //   reused when it exists for the same cost model and mode; --recalibrate rebuilds it
+        // --panels=N,N,...: also generate PanelGenerator panels of about N holes
+        bool integer_costs = false;
+        bool recalibrate = false;
+        std::string parameters_file = "results/parameter_store.txt";
+        bool race_calibration = true;
+        unsigned threads = 0;
+        CostModel cost_model;
+        std::vector<int> panel_sizes;
+        for (int a = 1; a < argc; a++) {
+            std::string arg(argv[a]);
+            if (arg == "--integer-costs") integer_costs = true;
+            if (arg.rfind("--threads=", 0) == 0) threads = std::stoul(arg.substr(10));
+            if (arg == "--calibration=grid") race_calibration = false;
+            if (arg == "--calibration=race") race_calibration = true;
+            if (arg.rfind("--parameters=", 0) == 0) parameters_file = arg.substr(13);
+            if (arg == "--recalibrate") recalibrate = true;
+            if (arg.rfind("--panels=", 0) == 0) {
+                std::stringstream list(arg.substr(9));
+                std::string size;
+                while (std::getline(list, size, ',')) {
+                    if (!size.empty()) panel_sizes.push_back(std::stoi(size));
+                }
+            }
+            if (arg.rfind("--cost-model=", 0) == 0) {
+                cost_model = CostModel(CostModel::parse(arg.substr(13)));
+            }
+        }
+
         std::vector<std::tuple<int, int, int>> board_configs = {
             {50, 50, 2},    // Small boards
             {75, 75, 3},    // Medium-small boards
@@ -228,20 +286,36 @@ int main(int argc, char const* argv[]) {
         std::cout << "Phase 1: Generating Training Instances\n"
             << "=====================================\n";
         generateInstanceSet(board_configs, 10);
+        if (!panel_sizes.empty()) generatePanelSet(panel_sizes, 3);
 
         std::cout << "\nPhase 2: Parameter Calibration\n"
             << "=============================\n";
-        ParameterCalibration calibrator;
-        auto params = calibrator.calibrateParameters(board_configs);
+        ParameterStore store(parameters_file, cost_model, integer_costs);
+        auto load_start = std::chrono::high_resolution_clock::now();
+        if (!recalibrate && store.load() && !store.empty()) {
+            std::cout << "Loaded " << store.getEntries().size() << " calibrated parameter sets ("
+                << store.costing() << ") from " << parameters_file << " in " << std::fixed << std::setprecision(3)
+                << std::chrono::duration<double, std::milli>(
+                    std::chrono::high_resolution_clock::now() - load_start).count() << " ms\n";
+        }
+        else {
+            ParameterCalibration calibrator(threads, cost_model, integer_costs);
+            if (race_calibration) calibrator.raceParameters(board_configs, {}, &store);
+            else calibrator.calibrateParameters(board_configs, &store);
+            store.save();
+        }
 
         std::ofstream calibration_log("results/calibration_results.txt");
-        calibration_log << "Calibration Results:\n"
-            << "Small instances - Tenure: " << params.small_tenure
-            << ", Iterations: " << params.small_iterations << "\n"
-            << "Medium instances - Tenure: " << params.medium_tenure
-            << ", Iterations: " << params.medium_iterations << "\n"
-            << "Large instances - Tenure: " << params.large_tenure
-            << ", Iterations: " << params.large_iterations << "\n";
+        calibration_log << "Calibration Results:\n";
+        for (const auto& entry : store.getEntries()) {
+            const auto& p = entry.params;
+            calibration_log << entry.label << " (" << entry.features.holes << " holes, "
+                << entry.features.density << " holes/cm2) - Tenure: " << p.tenure
+                << " in [" << p.min_tenure << ", " << p.max_tenure
+                << "], Iterations: " << p.iterations
+                << ", Iterations without improvement: " << p.max_iterations_without_improvement
+                << ", Intensification iterations: " << p.intensification_iterations << "\n";
+        }
 
         std::cout << "\nPhase 3: Testing and Visualization\n"
             << "================================\n";
@@ -253,16 +327,25 @@ int main(int argc, char const* argv[]) {
             int height = std::get<1>(config);
             int components = std::get<2>(config);
 
-            auto costs = TSPGenerator::generateCircuitBoard(width, height, components);
+            std::vector<BoardPattern> placed;
+            auto holes = TSPGenerator::generateHoles(width, height, components, 0, &placed);
+            auto features = InstanceFeatures::fromBoard(width, height, holes.size(), placed);
+            auto params = store.lookup(features);
             std::vector<std::pair<double, double>> points;
-            for (const auto& p : TSPGenerator::getLastGeneratedPoints()) {
+            for (const auto& p : holes) {
                 points.push_back({ p.x, p.y });
             }
 
             TSP tsp;
-            tsp.n = costs.size();
-            tsp.cost = costs;
             tsp.infinite = std::numeric_limits<double>::infinity();
+            if (integer_costs) {
+                double tick = cost_model.integerTick();
+                tsp.setIntegerCosts(cost_model.buildIntegerMatrix(holes, tick), tick);
+            }
+            else {
+                tsp.cost = cost_model.buildMatrix(holes);
+                tsp.n = tsp.cost.size();
+            }
 
             std::string prefix = "visualizations/board_" +
                 std::to_string(width) + "x" + std::to_string(height);
@@ -270,22 +353,8 @@ int main(int argc, char const* argv[]) {
             std::cout << "\nTesting " << width << "x" << height
                 << " board (" << tsp.n << " holes):\n";
 
-            TSPSolver solver;
-            if (tsp.n <= 20) {
-                solver.setTabuTenure(params.small_tenure);
-                solver.setMaxIterations(params.small_iterations);
-            }
-            else if (tsp.n <= 35) {
-                solver.setTabuTenure(params.medium_tenure);
-                solver.setMaxIterations(params.medium_iterations);
-            }
-            else {
-                solver.setTabuTenure(params.large_tenure);
-                solver.setMaxIterations(params.large_iterations);
-            }
-
             solveAndVisualize(tsp, points, params, prefix);
-            TestResults bench_results = runBenchmark(tsp, solver);
+            TestResults bench_results = runBenchmark(tsp, params);
             all_results.push_back(bench_results);
 
             results_log << "\nInstance " << width << "x" << height
@@ -294,7 +363,11 @@ int main(int argc, char const* argv[]) {
                 << "Best Cost: " << bench_results.best_cost << "\n"
                 << "Worst Cost: " << bench_results.worst_cost << "\n"
                 << "Improvement: " << bench_results.improvement_percentage << "%\n"
-                << "Average Time: " << bench_results.avg_time << "ms\n";
+                << "Average Time: " << bench_results.avg_time << "ms\n"
+                << "Median Time: " << bench_results.median_time << "ms\n"
+                << "Lower Bound: " << bench_results.lower_bound << "\n"
+                << "Gap (best/average): " << bench_results.best_gap << "% / "
+                << bench_results.avg_gap << "%\n";
         }
 
         analyzeResults(all_results, results_log);
@@ -1,131 +1,249 @@
 #include "parameter_calibration.h"
 #include "TSPSolver.h"
 #include "data_generator.h"
+#include "lower_bound.h"
+#include "parameter_store.h"
+#include "thread_pool.h"
 #include <chrono>
 #include <numeric>
 #include <cmath>
 #include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+#include <random>
+
+const char* ParameterCalibration::className(SizeClass cls) {
+    switch (cls) {
+    case SMALL: return "small";
+    case MEDIUM: return "medium";
+    default: return "large";
+    }
+}
+
+void ParameterCalibration::ClassParameters::applyTo(TSPSolver& solver) const {
+    solver.setTabuTenure(tenure);
+    solver.setMaxIterations(iterations);
+    solver.setTenureRange(min_tenure, max_tenure);
+    solver.setMaxIterationsWithoutImprovement(max_iterations_without_improvement);
+    solver.setIntensificationIterations(intensification_iterations);
+}
+
+void ParameterCalibration::Parameters::applyTo(TSPSolver& solver, int n) const {
+    forSize(n).applyTo(solver);
+}
+
+std::vector<std::vector<ParameterCalibration::TrainingInstance>>
+ParameterCalibration::generateTrainingSets(
+    const std::vector<std::tuple<int, int, int>>& board_configs, int per_class) const {
+
+    std::vector<std::vector<TrainingInstance>> sets(SIZE_CLASSES);
+    if (board_configs.empty()) return sets;
+
+    // Cycle through the board configurations with consecutive seeds and sort
+    // each board into its size class until every class is full
+    unsigned board_seed = seed;
+    const std::size_t target = static_cast<std::size_t>(std::max(per_class, 1));
+    for (int attempt = 0; attempt < BOARDS_PER_INSTANCE * static_cast<int>(target); attempt++) {
+        bool full = true;
+        for (const auto& set : sets) full = full && set.size() >= target;
+        if (full) break;
+
+        const auto& config = board_configs[attempt % board_configs.size()];
+        std::vector<BoardPattern> placed;
+        auto holes = TSPGenerator::generateHoles(
+            std::get<0>(config),
+            std::get<1>(config),
+            std::get<2>(config),
+            ++board_seed,
+            &placed
+        );
+        auto& set = sets[sizeClass(static_cast<int>(holes.size()))];
+        if (set.size() >= target) continue;
+
+        TrainingInstance instance;
+        if (integer_costs) {
+            const double tick = cost_model.integerTick();
+            instance.tsp.setIntegerCosts(cost_model.buildIntegerMatrix(holes, tick, 1), tick);
+        }
+        else {
+            instance.tsp.cost = cost_model.buildMatrix(holes, 1);
+            instance.tsp.n = instance.tsp.cost.size();
+        }
+        instance.tsp.infinite = 1e10;
+        instance.features = InstanceFeatures::fromBoard(std::get<0>(config), std::get<1>(config),
+            holes.size(), placed);
+        instance.reference = 0.0;
+        instance.solver_seed = seed + 7919u * board_seed;
+        set.push_back(std::move(instance));
+    }
+
+    // 1-tree bounds as quality references, one task per board
+    ThreadPool pool(threads);
+    std::vector<std::future<void>> bounds;
+    for (auto& set : sets) {
+        for (auto& instance : set) {
+            bounds.push_back(pool.submit([&instance] {
+                instance.reference = HeldKarpBound().compute(instance.tsp).bound;
+            }));
+        }
+    }
+    for (auto& f : bounds) f.get();
+
+    return sets;
+}
 
 ParameterCalibration::Parameters ParameterCalibration::calibrateParameters(
-    const std::vector<std::tuple<int, int, int>>& board_configs) {
+    const std::vector<std::tuple<int, int, int>>& board_configs,
+    ParameterStore* store) {
 
     Parameters best_params;
-    std::vector<TSP> training_instances;
-
-    // Generate training instances
-    for (const auto& config : board_configs) {
-        for (int i = 0; i < 5; i++) {  // 5 instances per configuration
-            auto costs = TSPGenerator::generateCircuitBoard(
-                std::get<0>(config),
-                std::get<1>(config),
-                std::get<2>(config)
-            );
-
-            TSP instance;
-            instance.n = costs.size();
-            instance.cost = costs;
-            instance.infinite = 1e10;
-            training_instances.push_back(instance);
+    auto training_sets = generateTrainingSets(board_configs, INSTANCES_PER_CLASS);
+
+    // One task per (class, combination, instance). An instance keeps the same
+    // solver seed, hence the same random start, across all combinations
+    ThreadPool pool(threads);
+    std::vector<std::future<RunResult>> runs;
+    for (const auto& set : training_sets) {
+        for (int tenure : tenure_values) {
+            for (int iter_mult : iteration_multipliers) {
+                for (const auto& instance : set) {
+                    Configuration config(tenure, iter_mult);
+                    runs.push_back(pool.submit([this, &instance, config] {
+                        return runInstance(instance, config);
+                    }));
+                }
+            }
         }
     }
 
-    // Test parameter combinations
-    double best_quality = std::numeric_limits<double>::infinity();
-
-    // Print table header
-    std::cout << "\n" << std::left << std::setw(10) << "Tenure"
-        << std::setw(15) << "Iterations"
-        << std::setw(15) << "Avg. Quality"
-        << std::setw(15) << "Std. Dev."
-        << std::setw(15) << "Avg. Time (ms)" << "\n";
-    std::cout << std::setfill('-') << std::setw(70) << "" << std::setfill(' ') << "\n";
-
-    for (int tenure : tenure_values) {
-        for (int iter_mult : iteration_multipliers) {
-            CalibrationResult result = testParameterCombination(
-                training_instances, tenure, iter_mult);
-
-            int iterations = iter_mult * training_instances[0].n;
-
-            // Print calibration results in a tabular format
-            std::cout << std::left << std::setw(10) << tenure
-                << std::setw(15) << iterations
-                << std::fixed << std::setprecision(3)
-                << std::setw(15) << result.avg_solution_quality
-                << std::setw(15) << result.std_dev_quality
-                << std::setw(15) << result.avg_time_ms << "\n";
-
-            // Update parameters based on instance size
-            if (result.avg_solution_quality < best_quality) {
-                best_quality = result.avg_solution_quality;
-
-                for (const auto& instance : training_instances) {
-                    if (instance.n <= 20) {
-                        best_params.small_tenure = tenure;
-                        best_params.small_iterations = iter_mult * instance.n;
-                    }
-                    else if (instance.n <= 35) {
-                        best_params.medium_tenure = tenure;
-                        best_params.medium_iterations = iter_mult * instance.n;
-                    }
-                    else {
-                        best_params.large_tenure = tenure;
-                        best_params.large_iterations = iter_mult * instance.n;
-                    }
+    // Results are consumed in submission order, independent of scheduling
+    std::size_t next = 0;
+    for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+        const auto& set = training_sets[cls];
+        if (set.empty()) {
+            std::cout << "\nNo " << className(SizeClass(cls))
+                << " training boards, keeping the default parameters\n";
+            continue;
+        }
+        double mean_n = 0.0;
+        for (const auto& instance : set) mean_n += instance.tsp.n;
+        mean_n /= set.size();
+
+        // Print table header
+        std::cout << "\n" << className(SizeClass(cls)) << " boards (" << set.size()
+            << " instances, mean " << std::fixed << std::setprecision(1) << mean_n << " holes)\n";
+        std::cout << std::left << std::setw(10) << "Tenure"
+            << std::setw(15) << "Iterations"
+            << std::setw(15) << "Avg. Gap (%)"
+            << std::setw(15) << "Std. Dev."
+            << std::setw(15) << "Avg. Time (ms)" << "\n";
+        std::cout << std::setfill('-') << std::setw(70) << "" << std::setfill(' ') << "\n";
+
+        std::vector<CalibrationResult> results;
+        std::vector<Configuration> configs;
+        for (int tenure : tenure_values) {
+            for (int iter_mult : iteration_multipliers) {
+                std::vector<RunResult> combination;
+                combination.reserve(set.size());
+                for (std::size_t k = 0; k < set.size(); k++) {
+                    combination.push_back(runs[next++].get());
                 }
+                int iterations = static_cast<int>(std::lround(iter_mult * mean_n));
+                CalibrationResult result = summarize(combination, tenure, iterations);
+
+                // Print calibration results in a tabular format
+                std::cout << std::left << std::setw(10) << tenure
+                    << std::setw(15) << iterations
+                    << std::fixed << std::setprecision(3)
+                    << std::setw(15) << result.avg_solution_quality
+                    << std::setw(15) << result.std_dev_quality
+                    << std::setw(15) << result.avg_time_ms << "\n";
+
+                results.push_back(result);
+                configs.push_back(Configuration(tenure, iter_mult));
             }
         }
+
+        std::vector<std::size_t> front = paretoFront(results);
+        std::size_t pick = selectFromFront(results, front);
+        best_params.classes[cls] = toClassParameters(configs[pick], mean_n);
+        record(store, SizeClass(cls), set, best_params.classes[cls]);
+
+        std::cout << "Pareto front:";
+        for (std::size_t i : front) {
+            std::cout << " (" << results[i].tenure << ", " << results[i].iterations << ": "
+                << std::setprecision(2) << results[i].avg_solution_quality << "%, "
+                << std::setprecision(1) << results[i].avg_time_ms << " ms)";
+        }
+        std::cout << "\n";
     }
 
     // Print summary of best parameters
     std::cout << "\nBest parameters found:\n";
-    std::cout << "Small instances - Tenure: " << best_params.small_tenure
-        << ", Iterations: " << best_params.small_iterations << "\n";
-    std::cout << "Medium instances - Tenure: " << best_params.medium_tenure
-        << ", Iterations: " << best_params.medium_iterations << "\n";
-    std::cout << "Large instances - Tenure: " << best_params.large_tenure
-        << ", Iterations: " << best_params.large_iterations << "\n";
+    for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+        const ClassParameters& p = best_params.classes[cls];
+        std::cout << className(SizeClass(cls)) << " instances - Tenure: " << p.tenure
+            << ", Iterations: " << p.iterations << "\n";
+    }
 
     return best_params;
 }
 
-ParameterCalibration::CalibrationResult ParameterCalibration::testParameterCombination(
-    const std::vector<TSP>& instances,
-    int tenure,
-    int iteration_multiplier) {
+ParameterCalibration::RunResult ParameterCalibration::runInstance(
+    const TrainingInstance& instance,
+    const Configuration& config) const {
 
-    CalibrationResult result{ tenure, iteration_multiplier, 0.0, 0.0, 0.0 };
-    std::vector<double> qualities;
-    double total_time_ms = 0.0;
+    const TSP& tsp = instance.tsp;
+    TSPSolver solver(instance.solver_seed);
+    TSPSolution initial(tsp);
+    TSPSolution final(tsp);
 
-    for (const auto& instance : instances) {
-        TSPSolver solver;
-        TSPSolution initial(instance);
-        TSPSolution final(instance);
+    solver.initRnd(initial);
+    solver.setTabuTenure(config.tenure);
+    solver.setMaxIterations(tsp.n * config.iteration_multiplier);
+    solver.setTenureRange(config.min_tenure, config.max_tenure);
+    solver.setMaxIterationsWithoutImprovement(config.max_iterations_without_improvement);
+    solver.setIntensificationIterations(config.intensification_iterations);
 
-        solver.initRnd(initial);
-        solver.setTabuTenure(tenure);
-        solver.setMaxIterations(instance.n * iteration_multiplier);
+    auto start = std::chrono::high_resolution_clock::now();
 
-        auto start = std::chrono::high_resolution_clock::now();
+    RunResult run{ false, 0.0, 0.0, 0 };
+    if (solver.solveWithTabuSearch(tsp, initial, final)) {
+        auto end = std::chrono::high_resolution_clock::now();
+        run.solved = true;
+        run.time_ms = std::chrono::duration<double, std::milli>(end - start).count();
+        run.iterations = solver.getIterations();
+        run.quality = HeldKarpBound::gap(solver.evaluate(final, tsp), instance.reference);
+    }
+    return run;
+}
 
-        std::vector<std::pair<double, double>> points;
+ParameterCalibration::CalibrationResult ParameterCalibration::summarize(
+    const std::vector<RunResult>& runs,
+    int tenure,
+    int iterations) const {
 
-        if (solver.solveWithTabuSearch(instance, initial, final, points)) {
-            auto end = std::chrono::high_resolution_clock::now();
-            auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
-                end - start).count();
+    CalibrationResult result{ tenure, iterations, 0.0, 0.0, 0.0, 0.0 };
+    std::vector<double> qualities;
+    double total_time_ms = 0.0;
+    double total_iterations = 0.0;
 
-            double quality = solver.evaluate(final, instance);
-            qualities.push_back(quality);
-            total_time_ms += duration;
+    for (const auto& run : runs) {
+        if (run.solved) {
+            qualities.push_back(run.quality);
+            total_time_ms += run.time_ms;
+            total_iterations += run.iterations;
         }
     }
 
     if (!qualities.empty()) {
         result.avg_solution_quality = std::accumulate(
             qualities.begin(), qualities.end(), 0.0) / qualities.size();
-        result.avg_time_ms = total_time_ms / instances.size();
+        result.avg_time_ms = total_time_ms / qualities.size();
+        result.avg_iterations = total_iterations / qualities.size();
 
         double variance = 0.0;
         for (double q : qualities) {
@@ -133,6 +251,313 @@ ParameterCalibration::CalibrationResult ParameterCalibration::testParameterCombi
         }
         result.std_dev_quality = std::sqrt(variance / qualities.size());
     }
+    else {
+        result.avg_solution_quality = std::numeric_limits<double>::infinity();
+    }
 
     return result;
-}
\ No newline at end of file
+}
+
+std::vector<std::size_t> ParameterCalibration::paretoFront(
+    const std::vector<CalibrationResult>& results) {
+
+    std::vector<std::size_t> front;
+    for (std::size_t i = 0; i < results.size(); i++) {
+        bool dominated = false;
+        for (std::size_t j = 0; j < results.size() && !dominated; j++) {
+            const auto& a = results[j];
+            const auto& b = results[i];
+            dominated = a.avg_solution_quality <= b.avg_solution_quality &&
+                a.avg_iterations <= b.avg_iterations &&
+                (a.avg_solution_quality < b.avg_solution_quality || a.avg_iterations < b.avg_iterations);
+        }
+        if (!dominated) front.push_back(i);
+    }
+    // Cheapest first; equal costs keep their input order
+    std::stable_sort(front.begin(), front.end(), [&](std::size_t a, std::size_t b) {
+        return results[a].avg_iterations < results[b].avg_iterations;
+    });
+    return front;
+}
+
+std::size_t ParameterCalibration::selectFromFront(const std::vector<CalibrationResult>& results,
+    const std::vector<std::size_t>& front) const {
+
+    double best_gap = std::numeric_limits<double>::infinity();
+    for (std::size_t i : front) best_gap = std::min(best_gap, results[i].avg_solution_quality);
+
+    // The front is sorted by cost: the first point close enough to the best gap
+    for (std::size_t i : front) {
+        if (results[i].avg_solution_quality <= best_gap + gap_tolerance) return i;
+    }
+    return front.front();
+}
+
+ParameterCalibration::ClassParameters ParameterCalibration::toClassParameters(
+    const Configuration& config, double mean_n) const {
+
+    ClassParameters p(config.tenure, static_cast<int>(std::lround(config.iteration_multiplier * mean_n)));
+    p.min_tenure = config.min_tenure;
+    p.max_tenure = config.max_tenure;
+    p.max_iterations_without_improvement = config.max_iterations_without_improvement;
+    p.intensification_iterations = config.intensification_iterations;
+    return p;
+}
+
+void ParameterCalibration::record(ParameterStore* store, SizeClass cls,
+    const std::vector<TrainingInstance>& set, const ClassParameters& params) {
+    if (!store) return;
+
+    std::vector<InstanceFeatures> features;
+    for (const auto& instance : set) features.push_back(instance.features);
+    store->add({ className(cls), InstanceFeatures::mean(features), params });
+}
+
+std::vector<ParameterCalibration::Configuration> ParameterCalibration::sampleConfigurations(
+    const RaceSettings& settings) const {
+
+    std::mt19937 rng(seed);
+    auto draw = [&rng](const Range& range) {
+        return std::uniform_int_distribution<int>(range.lo, std::max(range.lo, range.hi))(rng);
+    };
+
+    std::vector<Configuration> candidates;
+    candidates.reserve(settings.candidates);
+    for (int c = 0; c < settings.candidates; c++) {
+        Configuration config;
+        config.min_tenure = draw(settings.min_tenure);
+        config.max_tenure = std::max(config.min_tenure + 2, draw(settings.max_tenure));
+        // The starting tenure has to lie inside the reactive range
+        config.tenure = std::min(std::max(draw(settings.tenure), config.min_tenure), config.max_tenure);
+        config.iteration_multiplier = draw(settings.iteration_multiplier);
+        config.max_iterations_without_improvement = draw(settings.max_iterations_without_improvement);
+        config.intensification_iterations = draw(settings.intensification_iterations);
+        candidates.push_back(config);
+    }
+    return candidates;
+}
+
+namespace {
+
+    // Standard normal quantile by bisection on the CDF; only called a few
+    // times per race
+    double normalQuantile(double p) {
+        double lo = -10.0, hi = 10.0;
+        for (int i = 0; i < 100; i++) {
+            double mid = 0.5 * (lo + hi);
+            if (0.5 * std::erfc(-mid / std::sqrt(2.0)) < p) lo = mid;
+            else hi = mid;
+        }
+        return 0.5 * (lo + hi);
+    }
+
+    // Chi-square quantile, Wilson-Hilferty approximation
+    double chiSquareQuantile(double p, double df) {
+        double z = normalQuantile(p);
+        double h = 2.0 / (9.0 * df);
+        return df * std::pow(1.0 - h + z * std::sqrt(h), 3);
+    }
+
+    // Student t quantile, Cornish-Fisher expansion around the normal
+    double studentQuantile(double p, double df) {
+        double z = normalQuantile(p);
+        double z3 = z * z * z;
+        return z + (z3 + z) / (4.0 * df) + (5.0 * z3 * z * z + 16.0 * z3 + 3.0 * z) / (96.0 * df * df);
+    }
+
+}
+
+double ParameterCalibration::rankSums(const std::vector<std::vector<RaceScore>>& scores,
+    std::vector<double>& rank_sum) {
+
+    const std::size_t k = scores.empty() ? 0 : scores[0].size();
+    rank_sum.assign(k, 0.0);
+    double A = 0.0;
+    std::vector<std::size_t> order(k);
+    for (const auto& block : scores) {
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+            return block[a] < block[b];
+        });
+        for (std::size_t i = 0; i < k;) {
+            std::size_t j = i;
+            while (j + 1 < k && block[order[j + 1]] == block[order[i]]) j++;
+            double rank = 0.5 * (i + j) + 1.0;
+            for (std::size_t t = i; t <= j; t++) {
+                rank_sum[order[t]] += rank;
+                A += rank * rank;
+            }
+            i = j + 1;
+        }
+    }
+    return A;
+}
+
+std::vector<std::size_t> ParameterCalibration::friedmanSurvivors(
+    const std::vector<std::vector<RaceScore>>& scores, double alpha) {
+
+    const std::size_t n = scores.size();
+    const std::size_t k = scores.empty() ? 0 : scores[0].size();
+    std::vector<std::size_t> all(k);
+    std::iota(all.begin(), all.end(), 0);
+    if (n < 2 || k < 2) return all;
+
+    std::vector<double> rank_sum;
+    const double A = rankSums(scores, rank_sum);
+
+    const double nk = static_cast<double>(n), kk = static_cast<double>(k);
+    const double C = nk * kk * (kk + 1.0) * (kk + 1.0) / 4.0;
+    if (A - C <= 1e-12) return all;    // every instance fully tied
+
+    double sum_sq = 0.0;
+    for (double r : rank_sum) sum_sq += r * r;
+    const double T = (kk - 1.0) * (sum_sq - nk * C) / (A - C);
+    if (T <= chiSquareQuantile(1.0 - alpha, kk - 1.0)) return all;
+
+    // Conover: drop candidates significantly worse than the best rank sum
+    const double df = (nk - 1.0) * (kk - 1.0);
+    const double limit = studentQuantile(1.0 - alpha / 2.0, df) *
+        std::sqrt(2.0 * nk * (A - C) / df * std::max(0.0, 1.0 - T / (nk * (kk - 1.0))));
+    const double best = *std::min_element(rank_sum.begin(), rank_sum.end());
+
+    std::vector<std::size_t> survivors;
+    for (std::size_t c = 0; c < k; c++) {
+        if (rank_sum[c] - best <= limit) survivors.push_back(c);
+    }
+    return survivors;
+}
+
+std::vector<std::size_t> ParameterCalibration::betterHalf(
+    const std::vector<std::vector<RaceScore>>& scores) {
+
+    std::vector<double> rank_sum;
+    rankSums(scores, rank_sum);
+    std::vector<std::size_t> order(rank_sum.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return rank_sum[a] < rank_sum[b];
+    });
+    order.resize((order.size() + 1) / 2);
+    std::sort(order.begin(), order.end());
+    return order;
+}
+
+ParameterCalibration::Parameters ParameterCalibration::raceParameters(
+    const std::vector<std::tuple<int, int, int>>& board_configs,
+    const RaceSettings& settings,
+    ParameterStore* store) {
+
+    Parameters params;
+    auto training_sets = generateTrainingSets(board_configs, settings.instances);
+    ThreadPool pool(threads);
+    std::size_t total_runs = 0, total_exhaustive = 0;
+
+    for (int cls = 0; cls < SIZE_CLASSES; cls++) {
+        const auto& set = training_sets[cls];
+        if (set.empty()) {
+            std::cout << "\nNo " << className(SizeClass(cls))
+                << " training boards, keeping the default parameters\n";
+            continue;
+        }
+        double mean_n = 0.0;
+        for (const auto& instance : set) mean_n += instance.tsp.n;
+        mean_n /= set.size();
+
+        std::vector<Configuration> candidates = sampleConfigurations(settings);
+        std::vector<std::size_t> alive(candidates.size());
+        std::iota(alive.begin(), alive.end(), 0);
+        // gaps[b][c], times[b][c] and iterations[b][c] over all candidates
+        std::vector<std::vector<double>> gaps, times;
+        std::vector<std::vector<int>> iterations;
+        std::size_t runs_done = 0;
+        std::size_t boards_since_drop = 0;
+
+        std::cout << "\nRacing " << candidates.size() << " configurations over "
+            << set.size() << " " << className(SizeClass(cls)) << " boards\n";
+
+        for (std::size_t b = 0; b < set.size() && alive.size() > 1; b++) {
+            const TrainingInstance& instance = set[b];
+
+            std::vector<std::future<RunResult>> runs;
+            for (std::size_t c : alive) {
+                const Configuration& config = candidates[c];
+                runs.push_back(pool.submit([this, &instance, &config] {
+                    return runInstance(instance, config);
+                }));
+            }
+            gaps.emplace_back(candidates.size(), std::numeric_limits<double>::infinity());
+            times.emplace_back(candidates.size(), 0.0);
+            iterations.emplace_back(candidates.size(), 0);
+            for (std::size_t i = 0; i < alive.size(); i++) {
+                RunResult run = runs[i].get();
+                if (run.solved) gaps.back()[alive[i]] = run.quality;
+                times.back()[alive[i]] = run.time_ms;
+                iterations.back()[alive[i]] = run.iterations;
+            }
+            runs_done += alive.size();
+
+            if (b + 1 < static_cast<std::size_t>(settings.min_instances)) continue;
+
+            // Gaps within gap_resolution tie and are told apart by the
+            // iterations run, which unlike wall time is reproducible
+            std::vector<std::vector<RaceScore>> block(gaps.size(), std::vector<RaceScore>(alive.size()));
+            for (std::size_t i = 0; i < gaps.size(); i++) {
+                for (std::size_t j = 0; j < alive.size(); j++) {
+                    double gap = gaps[i][alive[j]];
+                    block[i][j] = { std::isfinite(gap) ? std::floor(gap / settings.gap_resolution) : gap,
+                        iterations[i][alive[j]] };
+                }
+            }
+            std::vector<std::size_t> keep = friedmanSurvivors(block, settings.alpha);
+            const char* reason = "Friedman test";
+            if (keep.size() == alive.size() &&
+                ++boards_since_drop >= static_cast<std::size_t>(std::max(settings.halving_interval, 1))) {
+                keep = betterHalf(block);
+                reason = "halving";
+            }
+            if (keep.size() < alive.size()) {
+                std::vector<std::size_t> next;
+                for (std::size_t j : keep) next.push_back(alive[j]);
+                alive.swap(next);
+                boards_since_drop = 0;
+                std::cout << "After " << b + 1 << " boards: " << alive.size()
+                    << " configurations left (" << reason << ")\n";
+            }
+        }
+
+        // Survivors compete on the quality/cost front over the boards they all ran
+        std::vector<CalibrationResult> results;
+        for (std::size_t c : alive) {
+            std::vector<RunResult> seen;
+            for (std::size_t b = 0; b < gaps.size(); b++) {
+                seen.push_back({ gaps[b][c] < std::numeric_limits<double>::infinity(), gaps[b][c],
+                    times[b][c], iterations[b][c] });
+            }
+            results.push_back(summarize(seen, candidates[c].tenure,
+                static_cast<int>(std::lround(candidates[c].iteration_multiplier * mean_n))));
+        }
+        std::vector<std::size_t> front = paretoFront(results);
+        const Configuration& best = candidates[alive[selectFromFront(results, front)]];
+        params.classes[cls] = toClassParameters(best, mean_n);
+        record(store, SizeClass(cls), set, params.classes[cls]);
+
+        const std::size_t exhaustive = candidates.size() * set.size();
+        total_runs += runs_done;
+        total_exhaustive += exhaustive;
+        std::cout << "Race finished with " << alive.size() << " configuration(s), "
+            << runs_done << " runs instead of " << exhaustive << " ("
+            << std::fixed << std::setprecision(1)
+            << (runs_done ? static_cast<double>(exhaustive) / runs_done : 0.0) << "x fewer)\n";
+        std::cout << "Best configuration - Tenure: " << best.tenure << " in [" << best.min_tenure
+            << ", " << best.max_tenure << "], Iterations: " << best.iteration_multiplier
+            << " x n, Stagnation limit: " << best.max_iterations_without_improvement
+            << ", Intensification: " << best.intensification_iterations << "\n";
+    }
+
+    if (total_runs > 0) {
+        std::cout << "\nRace total: " << total_runs << " runs instead of " << total_exhaustive << " ("
+            << std::fixed << std::setprecision(1)
+            << static_cast<double>(total_exhaustive) / total_runs << "x fewer)\n";
+    }
+    return params;
+}
@@ -0,0 +1,95 @@
+#include "parameter_store.h"
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <limits>
+#include <cmath>
+#include <iomanip>
+#include <algorithm>
+
+bool ParameterStore::load() {
+    std::ifstream file(path);
+    if (!file) return false;
+
+    std::string line;
+    if (!std::getline(file, line)) return false;
+    std::istringstream header(line);
+    std::string hash, magic, model, mode;
+    int version = 0;
+    if (!(header >> hash >> magic >> version >> model >> mode) || hash != "#" ||
+        magic != "tsp-parameter-store" || version != FORMAT_VERSION ||
+        model + " " + mode != costing()) {
+        return false;
+    }
+
+    std::vector<Entry> loaded;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        Entry e;
+        auto& p = e.params;
+        auto& f = e.features;
+        if (!(fields >> e.label >> f.holes >> f.density >> f.dip_share >> f.soic_share
+            >> f.connector_share >> p.tenure >> p.iterations >> p.min_tenure >> p.max_tenure
+            >> p.max_iterations_without_improvement >> p.intensification_iterations)) {
+            return false;
+        }
+        loaded.push_back(e);
+    }
+
+    entries.swap(loaded);
+    return true;
+}
+
+void ParameterStore::save() const {
+    std::ofstream file(path);
+    if (!file) throw std::runtime_error("Cannot write parameter store " + path);
+
+    file << "# tsp-parameter-store " << FORMAT_VERSION << " " << costing() << "\n"
+        << "# label holes density dip soic connector tenure iterations "
+        << "min_tenure max_tenure stagnation intensification\n";
+    file << std::setprecision(6);
+    for (const auto& e : entries) {
+        const auto& p = e.params;
+        const auto& f = e.features;
+        file << e.label << " " << f.holes << " " << f.density << " " << f.dip_share << " "
+            << f.soic_share << " " << f.connector_share << " " << p.tenure << " " << p.iterations
+            << " " << p.min_tenure << " " << p.max_tenure << " "
+            << p.max_iterations_without_improvement << " " << p.intensification_iterations << "\n";
+    }
+}
+
+void ParameterStore::add(const Entry& entry) {
+    for (auto& e : entries) {
+        if (e.label == entry.label) {
+            e = entry;
+            return;
+        }
+    }
+    entries.push_back(entry);
+}
+
+const ParameterStore::Entry* ParameterStore::nearest(const InstanceFeatures& features) const {
+    const Entry* best = nullptr;
+    double best_distance = std::numeric_limits<double>::infinity();
+    for (const auto& e : entries) {
+        double d = features.distance(e.features);
+        if (d < best_distance) {
+            best_distance = d;
+            best = &e;
+        }
+    }
+    return best;
+}
+
+ParameterCalibration::ClassParameters ParameterStore::lookup(const InstanceFeatures& features) const {
+    const Entry* e = nearest(features);
+    if (!e) return ParameterCalibration::ClassParameters();
+
+    // Budgets were calibrated as multiplier * n at the entry's mean size
+    ParameterCalibration::ClassParameters p = e->params;
+    if (e->features.holes > 0.0 && features.holes > 0.0) {
+        p.iterations = std::max(1, static_cast<int>(std::lround(p.iterations * features.holes / e->features.holes)));
+    }
+    return p;
+}
@@ -0,0 +1,246 @@
+#include "raster_renderer.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    struct Crc32Table {
+        uint32_t entries[256];
+        Crc32Table() {
+            for (uint32_t n = 0; n < 256; n++) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; k++) {
+                    c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+        }
+    };
+
+    uint32_t crc32(const uint8_t* data, std::size_t length, uint32_t crc = 0) {
+        static const Crc32Table table;
+        crc = ~crc;
+        for (std::size_t i = 0; i < length; i++) {
+            crc = table.entries[(crc ^ data[i]) & 0xff] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void appendU32(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    // Chunks are written in place: beginChunk() reserves length and type,
+    // the payload is appended, finishChunk() fills them in and adds the CRC
+    void finishChunk(std::vector<uint8_t>& out, std::size_t chunk_start, const char type[4]) {
+        uint32_t length = static_cast<uint32_t>(out.size() - chunk_start - 8);
+        uint8_t* header = out.data() + chunk_start;
+        header[0] = static_cast<uint8_t>(length >> 24);
+        header[1] = static_cast<uint8_t>(length >> 16);
+        header[2] = static_cast<uint8_t>(length >> 8);
+        header[3] = static_cast<uint8_t>(length);
+        std::memcpy(header + 4, type, 4);
+        appendU32(out, crc32(header + 4, length + 4));
+    }
+
+    std::size_t beginChunk(std::vector<uint8_t>& out) {
+        std::size_t start = out.size();
+        out.resize(start + 8);
+        return start;
+    }
+}
+
+RasterRenderer::RasterRenderer(const std::vector<std::pair<double, double>>& points, int width,
+    int margin, int hole_radius) :
+    width(std::max(width, 2 * margin + 1)), height(0), hole_radius(hole_radius) {
+
+    double minX = 0, minY = 0, maxX = 0, maxY = 0;
+    if (!points.empty()) {
+        minX = maxX = points[0].first;
+        minY = maxY = points[0].second;
+        for (const auto& p : points) {
+            minX = std::min(minX, p.first);
+            maxX = std::max(maxX, p.first);
+            minY = std::min(minY, p.second);
+            maxY = std::max(maxY, p.second);
+        }
+    }
+
+    int inner = this->width - 2 * margin;
+    double spanX = maxX - minX;
+    double spanY = maxY - minY;
+    double maxSpan = std::max(spanX, spanY);
+    double scale = maxSpan > 0 ? (inner - 1) / maxSpan : 1.0;
+    height = std::min(static_cast<int>(std::ceil(spanY * scale)) + 1 + 2 * margin, this->width);
+
+    pixel_points.reserve(points.size());
+    for (const auto& p : points) {
+        pixel_points.push_back({ margin + static_cast<int>(std::lround((p.first - minX) * scale)),
+            margin + static_cast<int>(std::lround((p.second - minY) * scale)) });
+    }
+    pixels.assign(static_cast<std::size_t>(this->width) * height, BACKGROUND);
+
+    // White background, blue holes, blue-to-red bands like BoardVisualizer
+    palette = { 255, 255, 255, 0, 0, 255 };
+    for (int band = 0; band < GRADIENT_BANDS; band++) {
+        uint8_t red = static_cast<uint8_t>(255 * band / (GRADIENT_BANDS - 1));
+        palette.push_back(red);
+        palette.push_back(0);
+        palette.push_back(static_cast<uint8_t>(255 - red));
+    }
+}
+
+void RasterRenderer::render(const std::vector<int>& tour) {
+    std::fill(pixels.begin(), pixels.end(), static_cast<uint8_t>(BACKGROUND));
+
+    int count = static_cast<int>(pixel_points.size());
+    std::size_t edges = tour.size() > 1 ? tour.size() - 1 : 0;
+    for (std::size_t i = 0; i < edges; i++) {
+        int a = tour[i];
+        int b = tour[i + 1];
+        if (a < 0 || a >= count || b < 0 || b >= count) continue;
+        uint8_t color = static_cast<uint8_t>(FIRST_BAND + i * GRADIENT_BANDS / edges);
+        drawLine(pixel_points[a].first, pixel_points[a].second,
+            pixel_points[b].first, pixel_points[b].second, color);
+    }
+
+    for (const auto& p : pixel_points) {
+        drawHole(p.first, p.second);
+    }
+}
+
+void RasterRenderer::drawLine(int x0, int y0, int x1, int y1, uint8_t color) {
+    // Endpoints are inside the image by construction
+    int dx = std::abs(x1 - x0);
+    int dy = -std::abs(y1 - y0);
+    int sx = x0 < x1 ? 1 : -1;
+    int sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+    for (;;) {
+        pixels[static_cast<std::size_t>(y0) * width + x0] = color;
+        if (x0 == x1 && y0 == y1) break;
+        int e2 = 2 * err;
+        if (e2 >= dy) {
+            err += dy;
+            x0 += sx;
+        }
+        if (e2 <= dx) {
+            err += dx;
+            y0 += sy;
+        }
+    }
+}
+
+void RasterRenderer::drawHole(int x, int y) {
+    int x0 = std::max(x - hole_radius, 0);
+    int x1 = std::min(x + hole_radius, width - 1);
+    int y0 = std::max(y - hole_radius, 0);
+    int y1 = std::min(y + hole_radius, height - 1);
+    for (int row = y0; row <= y1; row++) {
+        std::fill_n(pixels.begin() + static_cast<std::size_t>(row) * width + x0, x1 - x0 + 1,
+            static_cast<uint8_t>(HOLE));
+    }
+}
+
+void RasterRenderer::writePNG(const std::string& filename) {
+    static const uint8_t SIGNATURE[8] = { 137, 'P', 'N', 'G', '\r', '\n', 26, '\n' };
+    static const std::size_t MAX_STORED_BLOCK = 65535;
+
+    std::size_t raw_size = static_cast<std::size_t>(width + 1) * height;  // filter byte per row
+    std::size_t blocks = (raw_size + MAX_STORED_BLOCK - 1) / MAX_STORED_BLOCK;
+    encoded.clear();
+    encoded.reserve(64 + palette.size() + raw_size + 5 * blocks + 6);
+    encoded.insert(encoded.end(), SIGNATURE, SIGNATURE + 8);
+
+    std::size_t chunk = beginChunk(encoded);
+    appendU32(encoded, static_cast<uint32_t>(width));
+    appendU32(encoded, static_cast<uint32_t>(height));
+    const uint8_t ihdr_tail[5] = { 8, 3, 0, 0, 0 };  // 8-bit indexed, no interlace
+    encoded.insert(encoded.end(), ihdr_tail, ihdr_tail + 5);
+    finishChunk(encoded, chunk, "IHDR");
+
+    chunk = beginChunk(encoded);
+    encoded.insert(encoded.end(), palette.begin(), palette.end());
+    finishChunk(encoded, chunk, "PLTE");
+
+    // zlib stream of stored deflate blocks over the filtered scanlines
+    chunk = beginChunk(encoded);
+    encoded.push_back(0x78);
+    encoded.push_back(0x01);
+    uint32_t adler_a = 1, adler_b = 0;
+    std::size_t row = 0, column = 0;   // column 0 is the filter byte
+    std::size_t remaining = raw_size;
+    while (remaining > 0) {
+        std::size_t length = std::min(remaining, MAX_STORED_BLOCK);
+        remaining -= length;
+        encoded.push_back(remaining == 0 ? 1 : 0);
+        encoded.push_back(static_cast<uint8_t>(length));
+        encoded.push_back(static_cast<uint8_t>(length >> 8));
+        encoded.push_back(static_cast<uint8_t>(~length));
+        encoded.push_back(static_cast<uint8_t>(~length >> 8));
+
+        std::size_t start = encoded.size();
+        while (length > 0) {
+            if (column == 0) {
+                encoded.push_back(0);   // filter: none
+                column = 1;
+                length--;
+                continue;
+            }
+            std::size_t take = std::min(length, static_cast<std::size_t>(width) + 1 - column);
+            const uint8_t* src = pixels.data() + row * width + (column - 1);
+            encoded.insert(encoded.end(), src, src + take);
+            column += take;
+            length -= take;
+            if (column == static_cast<std::size_t>(width) + 1) {
+                column = 0;
+                row++;
+            }
+        }
+
+        // Adler-32 in runs short enough that the sums cannot overflow
+        const uint8_t* data = encoded.data() + start;
+        std::size_t size = encoded.size() - start;
+        while (size > 0) {
+            std::size_t run = std::min<std::size_t>(size, 5552);
+            for (std::size_t i = 0; i < run; i++) {
+                adler_a += data[i];
+                adler_b += adler_a;
+            }
+            adler_a %= 65521;
+            adler_b %= 65521;
+            data += run;
+            size -= run;
+        }
+    }
+    appendU32(encoded, (adler_b << 16) | adler_a);
+    finishChunk(encoded, chunk, "IDAT");
+
+    chunk = beginChunk(encoded);
+    finishChunk(encoded, chunk, "IEND");
+
+    writeFile(filename, encoded);
+}
+
+void RasterRenderer::writePPM(const std::string& filename) {
+    std::string header = "P6\n" + std::to_string(width) + " " + std::to_string(height) + "\n255\n";
+    encoded.assign(header.begin(), header.end());
+    encoded.reserve(header.size() + pixels.size() * 3);
+    for (uint8_t index : pixels) {
+        const uint8_t* rgb = palette.data() + 3 * index;
+        encoded.insert(encoded.end(), rgb, rgb + 3);
+    }
+    writeFile(filename, encoded);
+}
+
+void RasterRenderer::writeFile(const std::string& filename, const std::vector<uint8_t>& data) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot write image " + filename);
+    file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    if (!file) throw std::runtime_error("Error writing image " + filename);
+}
@@ -0,0 +1,199 @@
+#include "search_trace.h"
+#include <fstream>
+#include <stdexcept>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    const char MAGIC[8] = { 'T', 'S', 'P', 'T', 'R', 'A', 'C', 'E' };
+
+    template <typename T>
+    void writeValue(std::ofstream& file, const T& value) {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& file, T& value) {
+        return static_cast<bool>(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+SearchTrace::SearchTrace(std::size_t capacity, int keyframe_interval) :
+    capacity(capacity ? capacity : 1),
+    keyframe_interval(keyframe_interval > 0 ? keyframe_interval : 1),
+    sequence_length(0), ring(this->capacity), head(0), count(0), dropped(0) {}
+
+void SearchTrace::begin(const std::vector<int>& initial) {
+    sequence_length = initial.size();
+    base.assign(initial.begin(), initial.end());
+    head = 0;
+    count = 0;
+    dropped = 0;
+    for (auto& k : keyframes) {
+        spare_sequences.push_back(std::move(k.sequence));
+    }
+    keyframes.clear();
+}
+
+void SearchTrace::record(uint32_t iteration, uint32_t elapsed_us, double cost, int move_from,
+    int move_to, int tenure, uint8_t flags, const std::vector<int>& sequence) {
+    bool keyframe = (flags & (INTENSIFIED | DIVERSIFIED)) || iteration % keyframe_interval == 0;
+    if (count == capacity) {
+        // Roll the base forward over the record about to be overwritten
+        const Record& oldest = ring[head];
+        if (oldest.flags & KEYFRAME) {
+            base.swap(keyframes.front().sequence);
+            spare_sequences.push_back(std::move(keyframes.front().sequence));
+            keyframes.pop_front();
+        }
+        else {
+            std::reverse(base.begin() + oldest.move_from, base.begin() + oldest.move_to + 1);
+        }
+        dropped++;
+    }
+
+    if (keyframe) {
+        flags |= KEYFRAME;
+        Keyframe k;
+        k.iteration = iteration;
+        if (!spare_sequences.empty()) {
+            k.sequence = std::move(spare_sequences.back());
+            spare_sequences.pop_back();
+        }
+        k.sequence.assign(sequence.begin(), sequence.end());
+        keyframes.push_back(std::move(k));
+    }
+
+    Record& r = ring[head];
+    r.iteration = iteration;
+    r.elapsed_us = elapsed_us;
+    r.cost = static_cast<float>(cost);
+    r.move_from = static_cast<uint32_t>(move_from);
+    r.move_to = static_cast<uint32_t>(move_to);
+    r.tenure = static_cast<uint8_t>(std::min(tenure, 255));
+    r.flags = flags;
+    r.reserved = 0;
+
+    head = (head + 1) % capacity;
+    if (count < capacity) count++;
+}
+
+std::vector<SearchTrace::Record> SearchTrace::getRecords() const {
+    std::vector<Record> records;
+    records.reserve(count);
+    for (std::size_t i = 0; i < count; i++) {
+        records.push_back(at(i));
+    }
+    return records;
+}
+
+bool SearchTrace::tourAt(uint32_t iteration, std::vector<int>& sequence) const {
+    if (count == 0) return false;
+    uint32_t first = at(0).iteration;
+    uint32_t last = at(count - 1).iteration;
+    if (iteration < first || iteration > last) return false;
+
+    // Latest keyframe at or before the iteration, else the base
+    const Keyframe* start = nullptr;
+    for (const Keyframe& k : keyframes) {
+        if (k.iteration > iteration) break;
+        start = &k;
+    }
+
+    std::size_t from = 0;
+    if (start) {
+        sequence = start->sequence;
+        from = start->iteration + 1 - first;
+    }
+    else {
+        sequence = base;
+    }
+    for (std::size_t i = from; i <= iteration - first; i++) {
+        const Record& r = at(i);
+        if (r.move_to >= sequence.size()) return false;
+        std::reverse(sequence.begin() + r.move_from, sequence.begin() + r.move_to + 1);
+    }
+    return true;
+}
+
+void SearchTrace::flush(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary);
+    if (!file) throw std::runtime_error("Cannot write search trace " + path);
+
+    file.write(MAGIC, sizeof(MAGIC));
+    writeValue(file, FORMAT_VERSION);
+    writeValue(file, static_cast<uint32_t>(sizeof(Record)));
+    writeValue(file, static_cast<uint32_t>(points.size()));
+    writeValue(file, static_cast<uint32_t>(sequence_length));
+    writeValue(file, static_cast<uint32_t>(count));
+    writeValue(file, static_cast<uint32_t>(keyframes.size()));
+    writeValue(file, dropped);
+
+    for (const auto& p : points) {
+        writeValue(file, p.first);
+        writeValue(file, p.second);
+    }
+    std::vector<int32_t> base_sequence(base.begin(), base.end());
+    file.write(reinterpret_cast<const char*>(base_sequence.data()), base_sequence.size() * sizeof(int32_t));
+    // The ring wraps at most once, so the records are two contiguous runs
+    std::size_t oldest = (head + capacity - count) % capacity;
+    std::size_t first_run = std::min(count, capacity - oldest);
+    file.write(reinterpret_cast<const char*>(&ring[oldest]), first_run * sizeof(Record));
+    file.write(reinterpret_cast<const char*>(ring.data()), (count - first_run) * sizeof(Record));
+    for (const Keyframe& k : keyframes) {
+        writeValue(file, k.iteration);
+        std::vector<int32_t> seq(k.sequence.begin(), k.sequence.end());
+        file.write(reinterpret_cast<const char*>(seq.data()), seq.size() * sizeof(int32_t));
+    }
+
+    if (!file) throw std::runtime_error("Error writing search trace " + path);
+}
+
+bool SearchTrace::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+
+    char magic[sizeof(MAGIC)];
+    uint32_t version, record_size, point_count, length, record_count, keyframe_total;
+    uint64_t dropped_records;
+    if (!file.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        !readValue(file, version) || version != FORMAT_VERSION ||
+        !readValue(file, record_size) || record_size != sizeof(Record) ||
+        !readValue(file, point_count) || !readValue(file, length) ||
+        !readValue(file, record_count) || !readValue(file, keyframe_total) ||
+        !readValue(file, dropped_records)) {
+        return false;
+    }
+
+    std::vector<std::pair<double, double>> loaded_points(point_count);
+    for (auto& p : loaded_points) {
+        if (!readValue(file, p.first) || !readValue(file, p.second)) return false;
+    }
+    std::vector<int32_t> seq(length);
+    if (!file.read(reinterpret_cast<char*>(seq.data()), seq.size() * sizeof(int32_t))) return false;
+    std::vector<int> loaded_base(seq.begin(), seq.end());
+    std::vector<Record> records(std::max<uint32_t>(record_count, 1));
+    if (!file.read(reinterpret_cast<char*>(records.data()), record_count * sizeof(Record))) {
+        return false;
+    }
+    std::deque<Keyframe> loaded_keyframes(keyframe_total);
+    for (uint32_t i = 0; i < keyframe_total; i++) {
+        if (!readValue(file, loaded_keyframes[i].iteration) ||
+            !file.read(reinterpret_cast<char*>(seq.data()), seq.size() * sizeof(int32_t))) {
+            return false;
+        }
+        loaded_keyframes[i].sequence.assign(seq.begin(), seq.end());
+    }
+
+    // Full rings starting at slot 0
+    points.swap(loaded_points);
+    sequence_length = length;
+    base.swap(loaded_base);
+    ring.swap(records);
+    capacity = ring.size();
+    count = record_count;
+    head = count % capacity;
+    dropped = dropped_records;
+    keyframes.swap(loaded_keyframes);
+    return true;
+}
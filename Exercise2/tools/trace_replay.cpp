@@ -0,0 +1,186 @@
+/**
+* @file trace_replay.cpp
+* @brief Replay and analysis of binary search traces
+*
+* Reads a trace written by SearchTrace::flush() (<board>_trace.bin) and
+* - prints a summary: buffered iterations, best cost and when it was found,
+*   intensification/diversification counts, time per iteration
+* - with --csv=FILE writes the convergence curve
+*   (iteration, elapsed_ms, cost, best, tenure, flags)
+* - with --render=ITER (or --render=best) rebuilds the tour after that
+*   iteration and renders it with BoardVisualizer (--svg=FILE, default
+*   <trace>_iter<ITER>.svg); --downsample=PX thins large boards
+* - with --frames=DIR writes an animation: every --every=K-th buffered
+*   iteration (default 1) as DIR/frame_NNNNNN.png (or .ppm with
+*   --format=ppm), --width=PX wide, through RasterRenderer
+*
+* Usage: trace_replay TRACE [--csv=FILE] [--render=ITER|best] [--svg=FILE]
+*                           [--downsample=PX] [--frames=DIR] [--every=K]
+*                           [--format=png|ppm] [--width=PX]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstdlib>
+#include <cstdio>
+#include <chrono>
+#include <filesystem>
+#include <algorithm>
+#include "search_trace.h"
+#include "raster_renderer.h"
+#include "visualization.h"
+
+int main(int argc, char const* argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0]
+            << " TRACE [--csv=FILE] [--render=ITER|best] [--svg=FILE] [--downsample=PX]"
+            << " [--frames=DIR] [--every=K] [--format=png|ppm] [--width=PX]\n";
+        return 1;
+    }
+
+    std::string trace_file = argv[1];
+    std::string csv_file, render, svg_file;
+    double downsample_px = 0.0;
+    std::string frames_dir, frame_format = "png";
+    int every = 1, frame_width = 800;
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg.rfind("--csv=", 0) == 0) csv_file = arg.substr(6);
+        else if (arg.rfind("--render=", 0) == 0) render = arg.substr(9);
+        else if (arg.rfind("--svg=", 0) == 0) svg_file = arg.substr(6);
+        else if (arg.rfind("--downsample=", 0) == 0) downsample_px = std::atof(arg.substr(13).c_str());
+        else if (arg.rfind("--frames=", 0) == 0) frames_dir = arg.substr(9);
+        else if (arg.rfind("--every=", 0) == 0) every = std::max(1, std::atoi(arg.substr(8).c_str()));
+        else if (arg.rfind("--format=", 0) == 0) frame_format = arg.substr(9);
+        else if (arg.rfind("--width=", 0) == 0) frame_width = std::atoi(arg.substr(8).c_str());
+        else {
+            std::cerr << "Unknown option " << arg << "\n";
+            return 1;
+        }
+    }
+    if (frame_format != "png" && frame_format != "ppm") {
+        std::cerr << "Unknown frame format " << frame_format << "\n";
+        return 1;
+    }
+
+    SearchTrace trace;
+    if (!trace.load(trace_file)) {
+        std::cerr << "Cannot read trace " << trace_file << "\n";
+        return 1;
+    }
+    std::vector<SearchTrace::Record> records = trace.getRecords();
+    if (records.empty()) {
+        std::cerr << "Trace " << trace_file << " holds no iterations\n";
+        return 1;
+    }
+
+    // Summary and convergence curve in one pass
+    std::ofstream csv;
+    if (!csv_file.empty()) {
+        csv.open(csv_file);
+        if (!csv) {
+            std::cerr << "Cannot write " << csv_file << "\n";
+            return 1;
+        }
+        csv << "iteration,elapsed_ms,cost,best,tenure,flags\n" << std::fixed << std::setprecision(3);
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    const SearchTrace::Record* best_record = nullptr;
+    int intensifications = 0, diversifications = 0, keyframes = 0;
+    for (const auto& r : records) {
+        if (r.cost < best) {
+            best = r.cost;
+            best_record = &r;
+        }
+        if (r.flags & SearchTrace::INTENSIFIED) intensifications++;
+        if (r.flags & SearchTrace::DIVERSIFIED) diversifications++;
+        if (r.flags & SearchTrace::KEYFRAME) keyframes++;
+        if (csv.is_open()) {
+            csv << r.iteration << "," << r.elapsed_us / 1000.0 << "," << r.cost << ","
+                << best << "," << static_cast<int>(r.tenure) << "," << static_cast<int>(r.flags) << "\n";
+        }
+    }
+
+    const auto& first = records.front();
+    const auto& last = records.back();
+    double span_us = static_cast<double>(last.elapsed_us) - first.elapsed_us;
+    std::cout << "Trace " << trace_file << "\n"
+        << "  Iterations: " << first.iteration << " - " << last.iteration
+        << " (" << records.size() << " buffered, " << trace.getDropped() << " dropped)\n"
+        << std::fixed << std::setprecision(2)
+        << "  Best cost: " << best << " at iteration " << best_record->iteration
+        << " (" << best_record->elapsed_us / 1000.0 << " ms)\n"
+        << "  Final cost: " << last.cost << "\n"
+        << "  Intensifications: " << intensifications
+        << ", diversifications: " << diversifications << ", keyframes: " << keyframes << "\n";
+    if (records.size() > 1) {
+        std::cout << "  Time per iteration: " << span_us / (records.size() - 1) << " us\n";
+    }
+
+    if (!render.empty()) {
+        uint32_t iteration;
+        try {
+            iteration = render == "best" ? best_record->iteration
+                : static_cast<uint32_t>(std::stoul(render));
+        }
+        catch (const std::exception&) {
+            std::cerr << "Invalid iteration " << render << "\n";
+            return 1;
+        }
+
+        std::vector<int> tour;
+        if (!trace.tourAt(iteration, tour)) {
+            std::cerr << "Iteration " << iteration << " cannot be reconstructed from this trace\n";
+            return 1;
+        }
+        if (trace.getPoints().empty()) {
+            std::cerr << "Trace " << trace_file << " holds no board coordinates\n";
+            return 1;
+        }
+        if (svg_file.empty()) {
+            svg_file = trace_file.substr(0, trace_file.rfind('.')) + "_iter" + std::to_string(iteration) + ".svg";
+        }
+        double cost = records[iteration - first.iteration].cost;
+        BoardVisualizer::generateSVG(trace.getPoints(), tour, svg_file, true, static_cast<int>(iteration), cost,
+            downsample_px);
+        std::cout << "  Rendered iteration " << iteration << " to " << svg_file << "\n";
+    }
+
+    if (!frames_dir.empty()) {
+        if (trace.getPoints().empty()) {
+            std::cerr << "Trace " << trace_file << " holds no board coordinates\n";
+            return 1;
+        }
+        std::filesystem::create_directories(frames_dir);
+
+        RasterRenderer renderer(trace.getPoints(), frame_width);
+        std::size_t frames = 0, index = 0;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            trace.replay([&](const SearchTrace::Record&, const std::vector<int>& tour) {
+                bool last_record = index + 1 == records.size();
+                if (index++ % every != 0 && !last_record) return;
+                char name[32];
+                std::snprintf(name, sizeof(name), "/frame_%06zu.", frames++);
+                renderer.render(tour);
+                if (frame_format == "png") renderer.writePNG(frames_dir + name + frame_format);
+                else renderer.writePPM(frames_dir + name + frame_format);
+            });
+        }
+        catch (const std::exception& e) {
+            std::cerr << e.what() << "\n";
+            return 1;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  Wrote " << frames << " " << renderer.getWidth() << "x" << renderer.getHeight()
+            << " frames to " << frames_dir << " (" << std::setprecision(0)
+            << (seconds > 0 ? frames / seconds : 0.0) << " frames/s)\n";
+    }
+
+    return 0;
+}